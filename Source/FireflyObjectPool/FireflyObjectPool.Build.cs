@@ -41,6 +41,8 @@ public class FireflyObjectPool : ModuleRules
 				"SlateCore",
 				"AIModule",
                 "Niagara",
+				"UMG",
+				"GeometryCollectionEngine",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
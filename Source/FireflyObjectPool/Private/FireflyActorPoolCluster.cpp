@@ -0,0 +1,26 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#include "FireflyActorPoolCluster.h"
+
+#include "GameFramework/Actor.h"
+#include "UObject/UObjectArray.h"
+
+
+int32 UFireflyActorPoolCluster::Build(const TArray<TObjectPtr<AActor>>& InActors)
+{
+	Actors = InActors;
+	CreateCluster();
+
+	const FUObjectCluster* Cluster = GUObjectClusters.GetObjectCluster(this);
+
+	return Cluster ? Cluster->Objects.Num() : 0;
+}
+
+void UFireflyActorPoolCluster::Dissolve()
+{
+	if (HasAnyInternalFlags(EInternalObjectFlags::ClusterRoot))
+	{
+		GUObjectClusters.DissolveCluster(this);
+	}
+	Actors.Empty();
+}
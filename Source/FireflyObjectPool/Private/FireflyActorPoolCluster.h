@@ -0,0 +1,30 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "FireflyActorPoolCluster.generated.h"
+
+/** 把一个对象池中待命的Actor组成GC簇的簇根，垃圾回收时整个簇只需检查一次可达性 */
+/** Cluster root grouping the Actors on standby in a pool into a GC cluster, so garbage collection checks the reachability of the whole cluster at once */
+UCLASS(Transient)
+class UFireflyActorPoolCluster : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool CanBeClusterRoot() const override { return true; }
+
+	// 用待命的Actor创建GC簇，返回簇中对象的数量。
+	// Create the GC cluster from the Actors on standby, return the number of objects in the cluster.
+	int32 Build(const TArray<TObjectPtr<AActor>>& InActors);
+
+	// 解散GC簇，之后簇根不再引用任何Actor。
+	// Dissolve the GC cluster, the cluster root doesn't reference any Actor afterwards.
+	void Dissolve();
+
+protected:
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> Actors;
+};
@@ -0,0 +1,45 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#include "FireflyActorPoolStock.h"
+
+#include "Engine/World.h"
+
+#include "FireflyObjectPoolWorldSubsystem.h"
+
+
+AFireflyActorPoolStock::AFireflyActorPoolStock()
+{
+	PrimaryActorTick.bCanEverTick = false;
+}
+
+void AFireflyActorPoolStock::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	const UWorld* World = GetWorld();
+	if (World && World->IsGameWorld())
+	{
+		UFireflyObjectPoolWorldSubsystem::ActorPool_AdoptBakedStock(this);
+	}
+}
+
+bool AFireflyActorPoolStock::IsStockUpToDate() const
+{
+	for (const FFireflyActorPoolStockEntry& Entry : Entries)
+	{
+		if (Entry.BakedActors.Num() != (IsValid(Entry.ActorClass) ? Entry.Count : 0))
+		{
+			return false;
+		}
+
+		for (const AActor* Actor : Entry.BakedActors)
+		{
+			if (!IsValid(Actor) || Actor->GetClass() != Entry.ActorClass)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
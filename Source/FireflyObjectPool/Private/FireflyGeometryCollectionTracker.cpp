@@ -0,0 +1,35 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#include "FireflyGeometryCollectionTracker.h"
+
+
+UFireflyGeometryCollectionTracker* UFireflyGeometryCollectionTracker::Get()
+{
+	static UFireflyGeometryCollectionTracker* Tracker = nullptr;
+	if (!Tracker)
+	{
+		Tracker = NewObject<UFireflyGeometryCollectionTracker>(GetTransientPackage());
+		Tracker->AddToRoot();
+	}
+
+	return Tracker;
+}
+
+void UFireflyGeometryCollectionTracker::Watch(UGeometryCollectionComponent* GeometryCollection)
+{
+	GeometryCollection->SetNotifyBreaks(true);
+	GeometryCollection->OnChaosBreakEvent.AddUniqueDynamic(this, &UFireflyGeometryCollectionTracker::OnChaosBreak);
+}
+
+bool UFireflyGeometryCollectionTracker::ConsumeFractured(const UGeometryCollectionComponent* GeometryCollection)
+{
+	return FracturedCollections.Remove(GeometryCollection) > 0;
+}
+
+void UFireflyGeometryCollectionTracker::OnChaosBreak(const FChaosBreakEvent& BreakEvent)
+{
+	if (UGeometryCollectionComponent* GeometryCollection = Cast<UGeometryCollectionComponent>(BreakEvent.Component))
+	{
+		FracturedCollections.Add(GeometryCollection);
+	}
+}
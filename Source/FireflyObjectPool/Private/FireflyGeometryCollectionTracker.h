@@ -0,0 +1,33 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GeometryCollection/GeometryCollectionComponent.h"
+#include "UObject/Object.h"
+#include "FireflyGeometryCollectionTracker.generated.h"
+
+/** 监听池化几何集合的破碎事件，记录待命前发生过破碎的几何集合，使回收时只重置真正破碎过的几何集合 */
+/** Listens to the break events of pooled geometry collections and records the ones that fractured before going dormant, so only the geometry collections that actually fractured are reset on release */
+UCLASS(Transient)
+class UFireflyGeometryCollectionTracker : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	static UFireflyGeometryCollectionTracker* Get();
+
+	// 开始监听几何集合的破碎事件，重复调用不会重复监听。
+	// Start listening to the break events of the geometry collection, calling it again doesn't listen twice.
+	void Watch(UGeometryCollectionComponent* GeometryCollection);
+
+	// 返回几何集合自上次调用以来是否发生过破碎，并清除记录。
+	// Return whether the geometry collection fractured since the last call, and clear the record.
+	bool ConsumeFractured(const UGeometryCollectionComponent* GeometryCollection);
+
+protected:
+	UFUNCTION()
+	void OnChaosBreak(const FChaosBreakEvent& BreakEvent);
+
+	TSet<TObjectKey<UGeometryCollectionComponent>> FracturedCollections;
+};
@@ -3,155 +3,554 @@
 #include "FireflyObjectPoolLibrary.h"
 
 #include "AIController.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimNodeBase.h"
+#include "BehaviorTree/BlackboardComponent.h"
 #include "BrainComponent.h"
+#include "Components/AudioComponent.h"
+#include "Components/DecalComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/World.h"
 #include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
+#include "GeometryCollection/GeometryCollectionComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Navigation/CrowdFollowingComponent.h"
+#include "Perception/AIPerceptionComponent.h"
 
 #include "NiagaraComponent.h"
 #include "Particles/ParticleSystemComponent.h"
 
+#include "FireflyGeometryCollectionTracker.h"
+
+static TAutoConsoleVariable<bool> CVarFireflyObjectPoolStripCosmeticsOnServer(
+	TEXT("Firefly.ObjectPool.StripCosmeticsOnServer"),
+	true,
+	TEXT("Whether pools with bStripCosmeticsOnServer enabled strip the cosmetic components (FX, audio, decal) of their actors on a dedicated server and skip them when activated or deactivated. Set to false to turn stripping off for all pools."));
+
 void UFireflyObjectPoolLibrary::UniversalBeginPlay_Actor(const UObject* WorldContextObject, AActor* Actor)
 {
 	Actor->SetActorTickEnabled(true);
 	Actor->SetActorEnableCollision(true);
 	Actor->SetActorHiddenInGame(false);
 
+	const bool bSkipCosmetics = ShouldStripCosmetics(Actor);
+
 	TInlineComponentArray<UActorComponent*>Components;
 	Actor->GetComponents(Components);
 	for (UActorComponent* Component : Components)
 	{
-		if (UParticleSystemComponent* ParticleSystem = Cast<UParticleSystemComponent>(Component))
+		if (!bSkipCosmetics || !IsCosmeticComponent(Component) || Component->IsRegistered())
 		{
-			ParticleSystem->SetActive(true, true);
-			ParticleSystem->ActivateSystem();
-
-			continue;
+			UniversalBeginPlay_Component(WorldContextObject, Component);
 		}
+	}
+}
+
+void UFireflyObjectPoolLibrary::UniversalEndPlay_Actor(const UObject* WorldContextObject, AActor* Actor)
+{
+	Actor->SetActorTickEnabled(false);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorHiddenInGame(true);
+
+	const bool bSkipCosmetics = ShouldStripCosmetics(Actor);
 
-		if (UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(Component))
+	TInlineComponentArray<UActorComponent*>Components;
+	Actor->GetComponents(Components);
+	for (UActorComponent* Component : Components)
+	{
+		if (!bSkipCosmetics || !IsCosmeticComponent(Component) || Component->IsRegistered())
 		{
-			Niagara->SetActive(true, true);
-			Niagara->ActivateSystem();
-			
-			continue;
+			UniversalEndPlay_Component(WorldContextObject, Component);
 		}
+	}
+}
 
-		if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component))
-		{
-			Primitive->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
-			Primitive->SetPhysicsLinearVelocity(FVector::ZeroVector);
-			Primitive->SetComponentTickEnabled(true);
-			Primitive->SetVisibility(true, true);
+void UFireflyObjectPoolLibrary::UniversalWarmUp_Actor(const UObject* WorldContextObject, AActor* Actor)
+{
+	UniversalEndPlay_Actor(WorldContextObject, Actor);
+}
 
-			Primitive->SetActive(true, true);
+bool UFireflyObjectPoolLibrary::ShouldStripCosmetics(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
 
+	return World && World->GetNetMode() == NM_DedicatedServer && CVarFireflyObjectPoolStripCosmeticsOnServer.GetValueOnGameThread();
+}
+
+bool UFireflyObjectPoolLibrary::IsCosmeticComponent(const UActorComponent* Component)
+{
+	return Component->IsA<UFXSystemComponent>() || Component->IsA<UAudioComponent>() || Component->IsA<UDecalComponent>();
+}
+
+// 组件是否被Actor自身（AActor以外的类）声明的对象属性或对象数组属性引用。
+// Whether the component is referenced by an object property or object array property declared by the Actor's own classes (other than AActor).
+static bool IsReferencedByActorProperty(const AActor* Actor, const UActorComponent* Component)
+{
+	for (TFieldIterator<FProperty> It(Actor->GetClass()); It; ++It)
+	{
+		const FProperty* Property = *It;
+		if (Property->GetOwnerClass() == AActor::StaticClass())
+		{
 			continue;
 		}
 
-		if (UMovementComponent* Movement = Cast<UMovementComponent>(Component))
+		if (const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property))
 		{
-			Movement->SetUpdatedComponent(Actor->GetRootComponent());
-			Movement->SetActive(true, true);
-			Movement->StopMovementImmediately();
-			if (UProjectileMovementComponent* ProjectileMovement = Cast<UProjectileMovementComponent>(Movement))
+			for (int32 i = 0; i < Property->ArrayDim; ++i)
 			{
-				ProjectileMovement->SetVelocityInLocalSpace(FVector::XAxisVector * ProjectileMovement->InitialSpeed);
+				if (ObjectProperty->GetObjectPropertyValue_InContainer(Actor, i) == Component)
+				{
+					return true;
+				}
 			}
 		}
+		else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			const FObjectPropertyBase* InnerProperty = CastField<FObjectPropertyBase>(ArrayProperty->Inner);
+			if (!InnerProperty)
+			{
+				continue;
+			}
 
-		Component->SetActive(true, true);
+			FScriptArrayHelper_InContainer ArrayHelper(ArrayProperty, Actor);
+			for (int32 i = 0; i < ArrayHelper.Num(); ++i)
+			{
+				if (InnerProperty->GetObjectPropertyValue(ArrayHelper.GetRawPtr(i)) == Component)
+				{
+					return true;
+				}
+			}
+		}
 	}
+
+	return false;
 }
 
-void UFireflyObjectPoolLibrary::UniversalEndPlay_Actor(const UObject* WorldContextObject, AActor* Actor)
+int32 UFireflyObjectPoolLibrary::StripCosmeticComponents(const UObject* WorldContextObject, AActor* Actor)
 {
-	Actor->SetActorTickEnabled(false);
-	Actor->SetActorEnableCollision(false);
-	Actor->SetActorHiddenInGame(true);
+	if (!IsValid(Actor) || !ShouldStripCosmetics(Actor))
+	{
+		return 0;
+	}
 
-	TInlineComponentArray<UActorComponent*>Components;
+	TInlineComponentArray<UActorComponent*> Components;
 	Actor->GetComponents(Components);
+
+	int32 NumStripped = 0;
 	for (UActorComponent* Component : Components)
 	{
-		if (UParticleSystemComponent* ParticleSystem = Cast<UParticleSystemComponent>(Component))
+		if (!IsCosmeticComponent(Component) || Component == Actor->GetRootComponent())
 		{
-			ParticleSystem->DeactivateSystem();
-			Component->SetActive(false);
+			continue;
+		}
 
+		const USceneComponent* SceneComponent = Cast<USceneComponent>(Component);
+		if (SceneComponent && SceneComponent->GetAttachChildren().Num() > 0)
+		{
 			continue;
 		}
 
-		if (UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(Component))
+		// 默认子对象和蓝图组件是类的一部分，销毁后仍会被属性和蓝图节点访问，只注销并阻止其自动注册和激活。
+		// Default subobjects and Blueprint components are part of the class and still accessed by properties and Blueprint nodes after being destroyed, so they are only unregistered and kept from registering and activating again.
+		const bool bPartOfClass = Component->CreationMethod == EComponentCreationMethod::Native
+			|| Component->CreationMethod == EComponentCreationMethod::SimpleConstructionScript;
+		if (bPartOfClass || IsReferencedByActorProperty(Actor, Component))
 		{
-			Niagara->DeactivateImmediate();
-			Component->SetActive(false);
+			if (!Component->IsRegistered())
+			{
+				continue;
+			}
 
-			continue;
+			Component->bAutoActivate = false;
+			Component->bAutoRegister = false;
+			Component->Deactivate();
+			Component->SetComponentTickEnabled(false);
+			Component->UnregisterComponent();
 		}
+		else
+		{
+			Component->DestroyComponent();
+		}
+		++NumStripped;
+	}
+
+	return NumStripped;
+}
+
+void UFireflyObjectPoolLibrary::UniversalBeginPlay_Component(const UObject* WorldContextObject,
+	UActorComponent* Component)
+{
+	if (UParticleSystemComponent* ParticleSystem = Cast<UParticleSystemComponent>(Component))
+	{
+		ParticleSystem->SetActive(true, true);
+		ParticleSystem->ActivateSystem();
 
-		if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component))
+		return;
+	}
+
+	if (UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(Component))
+	{
+		Niagara->SetActive(true, true);
+		Niagara->ActivateSystem();
+
+		return;
+	}
+
+	if (UGeometryCollectionComponent* GeometryCollection = Cast<UGeometryCollectionComponent>(Component))
+	{
+		// 待命期间物理代理一直保留，这里只恢复组件模板上的碰撞和物理模拟设置，使其以未破碎的簇重新参与解算。
+		// The physics proxy was kept while dormant, only restore the collision and physics simulation settings of the component template here so it takes part in the solver again as unbroken clusters.
+		const UGeometryCollectionComponent* Archetype = Cast<UGeometryCollectionComponent>(GeometryCollection->GetArchetype());
+		GeometryCollection->SetComponentTickEnabled(true);
+		GeometryCollection->SetVisibility(true, true);
+		GeometryCollection->SetActive(true, true);
+		GeometryCollection->SetCollisionEnabled(Archetype ? Archetype->GetCollisionEnabled() : ECollisionEnabled::QueryAndPhysics);
+		GeometryCollection->SetSimulatePhysics(Archetype ? Archetype->BodyInstance.bSimulatePhysics : true);
+		UFireflyGeometryCollectionTracker::Get()->Watch(GeometryCollection);
+
+		return;
+	}
+
+	if (USkeletalMeshComponent* SkeletalMesh = Cast<USkeletalMeshComponent>(Component))
+	{
+		// 恢复组件模板上的动画更新设置，复用保留下来的动画实例，重置其变量、状态机和动力学，并立即刷新一次姿势。
+		// Restore the anim update settings of the component template, reuse the preserved anim instance after resetting its variables, state machines and dynamics, and refresh the pose once right away.
+		const USkeletalMeshComponent* Archetype = Cast<USkeletalMeshComponent>(SkeletalMesh->GetArchetype());
+		SkeletalMesh->VisibilityBasedAnimTickOption = Archetype ? Archetype->VisibilityBasedAnimTickOption : EVisibilityBasedAnimTickOption::AlwaysTickPose;
+		SkeletalMesh->bNoSkeletonUpdate = Archetype ? Archetype->bNoSkeletonUpdate : false;
+
+		SkeletalMesh->SetPhysicsLinearVelocity(FVector::ZeroVector);
+		SkeletalMesh->SetComponentTickEnabled(true);
+		SkeletalMesh->SetVisibility(true, true);
+		SkeletalMesh->SetActive(true, true);
+
+		if (UAnimInstance* AnimInstance = SkeletalMesh->GetAnimInstance())
 		{
-			Primitive->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
-			Primitive->SetPhysicsLinearVelocity(FVector::ZeroVector);
-			Primitive->SetComponentTickEnabled(false);
-			Primitive->SetSimulatePhysics(false);
-			Primitive->SetVisibility(false, true);
-			Component->SetActive(false);
+			ResetAnimInstance(AnimInstance);
+		}
+		for (UAnimInstance* LinkedInstance : SkeletalMesh->GetLinkedAnimInstances())
+		{
+			ResetAnimInstance(LinkedInstance);
+		}
 
-			continue;
+		SkeletalMesh->ResetAnimInstanceDynamics(ETeleportType::ResetPhysics);
+		if (SkeletalMesh->GetAnimInstance())
+		{
+			SkeletalMesh->TickAnimation(0.f, false);
+			SkeletalMesh->RefreshBoneTransforms();
+		}
+
+		return;
+	}
+
+	if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component))
+	{
+		Primitive->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
+		Primitive->SetPhysicsLinearVelocity(FVector::ZeroVector);
+		Primitive->SetComponentTickEnabled(true);
+		Primitive->SetVisibility(true, true);
+
+		Primitive->SetActive(true, true);
+
+		return;
+	}
+
+	if (UCharacterMovementComponent* CharacterMovement = Cast<UCharacterMovementComponent>(Component))
+	{
+		// 待命时保留了UpdatedComponent，这里只清除残留的速度和力并恢复默认移动模式。
+		// The UpdatedComponent was kept while dormant, only clear the leftover velocity and forces and restore the default movement mode here.
+		CharacterMovement->SetActive(true, true);
+		CharacterMovement->StopMovementImmediately();
+		CharacterMovement->ClearAccumulatedForces();
+		CharacterMovement->SetDefaultMovementMode();
+
+		return;
+	}
+
+	if (UMovementComponent* Movement = Cast<UMovementComponent>(Component))
+	{
+		if (const AActor* Owner = Movement->GetOwner())
+		{
+			Movement->SetUpdatedComponent(Owner->GetRootComponent());
+		}
+		Movement->SetActive(true, true);
+		Movement->StopMovementImmediately();
+		if (UProjectileMovementComponent* ProjectileMovement = Cast<UProjectileMovementComponent>(Movement))
+		{
+			ProjectileMovement->SetVelocityInLocalSpace(FVector::XAxisVector * ProjectileMovement->InitialSpeed);
+		}
+	}
+
+	Component->SetActive(true, true);
+}
+
+void UFireflyObjectPoolLibrary::UniversalEndPlay_Component(const UObject* WorldContextObject,
+	UActorComponent* Component)
+{
+	if (UParticleSystemComponent* ParticleSystem = Cast<UParticleSystemComponent>(Component))
+	{
+		ParticleSystem->DeactivateSystem();
+		Component->SetActive(false);
+
+		return;
+	}
+
+	if (UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(Component))
+	{
+		Niagara->DeactivateImmediate();
+		Component->SetActive(false);
+
+		return;
+	}
+
+	if (UGeometryCollectionComponent* GeometryCollection = Cast<UGeometryCollectionComponent>(Component))
+	{
+		// 只有真正破碎过的几何集合才移除物理代理、把动态集合重置为静止集合并重新创建物理代理，使碎片恢复为完整的几何集合。
+		// Only the geometry collections that actually fractured have their physics proxy removed, their dynamic collection reset to the rest collection and the proxy recreated, so the pieces are restored to a whole geometry collection.
+		UFireflyGeometryCollectionTracker* Tracker = UFireflyGeometryCollectionTracker::Get();
+		if (Tracker->ConsumeFractured(GeometryCollection))
+		{
+			GeometryCollection->DestroyPhysicsState();
+			GeometryCollection->SetRestCollection(GeometryCollection->GetRestCollection());
+			GeometryCollection->RecreatePhysicsState();
 		}
+		Tracker->Watch(GeometryCollection);
+
+		// 保留物理代理，待命期间将其停放为关闭碰撞、不模拟并休眠的状态。
+		// Keep the physics proxy and park it while dormant: collision off, not simulating and asleep.
+		GeometryCollection->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		GeometryCollection->SetSimulatePhysics(false);
+		GeometryCollection->PutAllRigidBodiesToSleep();
+
+		GeometryCollection->SetComponentTickEnabled(false);
+		GeometryCollection->SetVisibility(false, true);
+		Component->SetActive(false);
 
-		if (UMovementComponent* Movement = Cast<UMovementComponent>(Component))
+		return;
+	}
+
+	if (USkeletalMeshComponent* SkeletalMesh = Cast<USkeletalMeshComponent>(Component))
+	{
+		// 保留动画实例而不是在重新启用时重新初始化，只停止蒙太奇。待命期间既不更新动画也不刷新骨骼。
+		// Keep the anim instance instead of reinitializing it on reactivation, only stop the montages. Neither tick the animation nor refresh the bones while dormant.
+		if (UAnimInstance* AnimInstance = SkeletalMesh->GetAnimInstance())
 		{
-			Movement->StopMovementImmediately();
-			Movement->SetUpdatedComponent(nullptr);
+			AnimInstance->StopAllMontages(0.f);
 		}
+		SkeletalMesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+		SkeletalMesh->bNoSkeletonUpdate = true;
 
+		SkeletalMesh->SetPhysicsLinearVelocity(FVector::ZeroVector);
+		SkeletalMesh->SetComponentTickEnabled(false);
+		SkeletalMesh->SetSimulatePhysics(false);
+		SkeletalMesh->SetVisibility(false, true);
 		Component->SetActive(false);
+
+		return;
 	}
+
+	if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component))
+	{
+		Primitive->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
+		Primitive->SetPhysicsLinearVelocity(FVector::ZeroVector);
+		Primitive->SetComponentTickEnabled(false);
+		Primitive->SetSimulatePhysics(false);
+		Primitive->SetVisibility(false, true);
+		Component->SetActive(false);
+
+		return;
+	}
+
+	if (UCharacterMovementComponent* CharacterMovement = Cast<UCharacterMovementComponent>(Component))
+	{
+		// 不清空UpdatedComponent，重新设置它会让角色移动重建缓存的胶囊体和Pawn引用。
+		// Don't clear the UpdatedComponent, setting it again makes the character movement rebuild its cached capsule and Pawn references.
+		CharacterMovement->StopMovementImmediately();
+		CharacterMovement->DisableMovement();
+		Component->SetActive(false);
+
+		return;
+	}
+
+	if (UMovementComponent* Movement = Cast<UMovementComponent>(Component))
+	{
+		Movement->StopMovementImmediately();
+		Movement->SetUpdatedComponent(nullptr);
+	}
+
+	Component->SetActive(false);
 }
 
-void UFireflyObjectPoolLibrary::UniversalWarmUp_Actor(const UObject* WorldContextObject, AActor* Actor)
+void UFireflyObjectPoolLibrary::UniversalWarmUp_Component(const UObject* WorldContextObject,
+	UActorComponent* Component)
 {
-	UniversalEndPlay_Actor(WorldContextObject, Actor);
+	UniversalEndPlay_Component(WorldContextObject, Component);
 }
 
-void UFireflyObjectPoolLibrary::UniversalBeginPlay_Pawn(const UObject* WorldContextObject, APawn* Pawn)
+// 池化Pawn的AI控制器暂停和恢复逻辑时使用的原因。
+// Reason used when the AI controller of a pooled Pawn pauses and resumes its logic.
+static const TCHAR* FireflyPoolingLogicReason = TEXT("FireflyObjectPool");
+
+// 暂停待命Pawn的AI控制器。控制器保持占有Pawn，这样重新启用时不需要重新生成控制器，也不会触发重建行为树的OnUnPossess和OnPossess。
+// Pause the AI controller of a dormant Pawn. The controller keeps possessing the Pawn, so reactivation neither spawns a new controller nor triggers OnUnPossess and OnPossess, which rebuild the behavior tree.
+static void PausePooledAIController(AAIController* AIController)
 {
-	UniversalBeginPlay_Actor(WorldContextObject, Pawn);
+	AIController->StopMovement();
+	AIController->ClearFocus(EAIFocusPriority::Gameplay);
+	if (UBrainComponent* Brain = AIController->GetBrainComponent())
+	{
+		Brain->PauseLogic(FireflyPoolingLogicReason);
+	}
 
-	Pawn->SpawnDefaultController();
-	if (IsValid(Pawn->GetController()))
+	// 待命期间不再感知，也不作为群体避让的代理，遗忘已感知的目标使重新启用时从头感知。
+	// No perception while dormant and no agent in the crowd avoidance either, forget the perceived targets so perception starts over on reactivation.
+	if (UAIPerceptionComponent* Perception = AIController->GetAIPerceptionComponent())
+	{
+		Perception->ForgetAll();
+		Perception->Deactivate();
+	}
+	if (UCrowdFollowingComponent* CrowdFollowing = Cast<UCrowdFollowingComponent>(AIController->GetPathFollowingComponent()))
+	{
+		CrowdFollowing->SetCrowdSimulationState(ECrowdSimulationState::Disabled);
+	}
+
+	AIController->SetActorTickEnabled(false);
+}
+
+// 恢复被暂停的AI控制器，重置黑板并从头重新运行保留下来的行为树实例。
+// Resume a paused AI controller, reset its blackboard and rerun the preserved behavior tree instance from the start.
+static void ResumePooledAIController(AAIController* AIController)
+{
+	AIController->SetActorTickEnabled(true);
+
+	if (UAIPerceptionComponent* Perception = AIController->GetAIPerceptionComponent())
+	{
+		Perception->Activate(true);
+	}
+
+	// 只恢复组件模板上启用了群体模拟的控制器。
+	// Only restore the crowd simulation of controllers whose component template has it enabled.
+	UCrowdFollowingComponent* CrowdFollowing = Cast<UCrowdFollowingComponent>(AIController->GetPathFollowingComponent());
+	const UCrowdFollowingComponent* CrowdArchetype = CrowdFollowing ? Cast<UCrowdFollowingComponent>(CrowdFollowing->GetArchetype()) : nullptr;
+	if (CrowdFollowing && (!CrowdArchetype || CrowdArchetype->IsCrowdSimulationEnabled()))
+	{
+		CrowdFollowing->SetCrowdSimulationState(ECrowdSimulationState::Enabled);
+	}
+
+	UBrainComponent* Brain = AIController->GetBrainComponent();
+	if (!Brain)
 	{
-		if (const AAIController* AIController = Cast<AAIController>(Pawn->GetController()))
+		return;
+	}
+
+	if (!Brain->IsPaused())
+	{
+		if (!Brain->IsRunning())
 		{
-			if (UBrainComponent* Brain = AIController->GetBrainComponent())
-			{
-				Brain->StartLogic();
-			}
+			Brain->StartLogic();
 		}
+
+		return;
 	}
+
+	if (UBlackboardComponent* Blackboard = AIController->GetBlackboardComponent())
+	{
+		for (int32 KeyID = 0; KeyID < Blackboard->GetNumKeys(); ++KeyID)
+		{
+			Blackboard->ClearValue(static_cast<FBlackboard::FKey>(KeyID));
+		}
+		Blackboard->SetValueAsObject(FBlackboard::KeySelf, AIController->GetPawn());
+	}
+
+	Brain->ResumeLogic(FireflyPoolingLogicReason);
+	Brain->RestartLogic();
 }
 
-void UFireflyObjectPoolLibrary::UniversalEndPlay_Pawn(const UObject* WorldContextObject, APawn* Pawn)
+void UFireflyObjectPoolLibrary::ResetAnimInstance(UAnimInstance* AnimInstance)
 {
-	UniversalEndPlay_Actor(WorldContextObject, Pawn);
+	if (!IsValid(AnimInstance))
+	{
+		return;
+	}
 
-	if (IsValid(Pawn->GetController()))
+	// 每个动画蓝图类可还原的变量只收集一次。动画节点由重新初始化处理，对象引用（通常在初始化时缓存的Pawn等）保持不变。
+	// The resettable variables of every Anim Blueprint class are only collected once. Anim nodes are handled by the re-initialization, object references (usually the Pawn etc. cached on initialization) are left untouched.
+	static TMap<TObjectKey<UClass>, TArray<const FProperty*>> VariablesOfClass;
+
+	UClass* AnimClass = AnimInstance->GetClass();
+	TArray<const FProperty*>* Variables = VariablesOfClass.Find(AnimClass);
+	if (!Variables)
 	{
-		if (const AAIController* AIController = Cast<AAIController>(Pawn->GetController()))
+		Variables = &VariablesOfClass.Add(AnimClass);
+		for (TFieldIterator<FProperty> It(AnimClass); It; ++It)
 		{
-			if (UBrainComponent* Brain = AIController->GetBrainComponent())
+			const FProperty* Property = *It;
+			TArray<const FStructProperty*> EncounteredStructProps;
+			if (Property->GetOwnerClass()->HasAnyClassFlags(CLASS_Native)
+				|| Property->GetFName() == UBlueprintGeneratedClass::GetUberGraphFrameName()
+				|| Property->IsA<FMulticastDelegateProperty>() || Property->IsA<FDelegateProperty>()
+				|| Property->ContainsObjectReference(EncounteredStructProps, EPropertyObjectReferenceType::Strong | EPropertyObjectReferenceType::Weak))
 			{
-				Brain->Cleanup();
+				continue;
 			}
+
+			const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+			if (StructProperty && StructProperty->Struct->IsChildOf(FAnimNode_Base::StaticStruct()))
+			{
+				continue;
+			}
+
+			Variables->Add(Property);
 		}
 	}
+
+	const UObject* Defaults = AnimClass->GetDefaultObject();
+	for (const FProperty* Property : *Variables)
+	{
+		if (!Property->Identical_InContainer(AnimInstance, Defaults))
+		{
+			Property->CopyCompleteValue_InContainer(AnimInstance, Defaults);
+		}
+	}
+
+	AnimInstance->InitializeAnimation();
+}
+
+void UFireflyObjectPoolLibrary::UniversalBeginPlay_Pawn(const UObject* WorldContextObject, APawn* Pawn)
+{
+	UniversalBeginPlay_Actor(WorldContextObject, Pawn);
+
+	Pawn->SpawnDefaultController();
+	if (AAIController* AIController = Cast<AAIController>(Pawn->GetController()))
+	{
+		ResumePooledAIController(AIController);
+	}
+}
+
+void UFireflyObjectPoolLibrary::UniversalEndPlay_Pawn(const UObject* WorldContextObject, APawn* Pawn)
+{
+	UniversalEndPlay_Actor(WorldContextObject, Pawn);
+
+	if (AAIController* AIController = Cast<AAIController>(Pawn->GetController()))
+	{
+		PausePooledAIController(AIController);
+	}
 }
 
 void UFireflyObjectPoolLibrary::UniversalWarmUp_Pawn(const UObject* WorldContextObject, APawn* Pawn)
 {
 	UniversalWarmUp_Actor(WorldContextObject, Pawn);
+
+	// 预热时就生成AI控制器，使之后每次从对象池取出都不需要分配。
+	// Spawn the AI controller on warm-up already, so later fetches from the pool allocate nothing.
+	Pawn->SpawnDefaultController();
+	if (AAIController* AIController = Cast<AAIController>(Pawn->GetController()))
+	{
+		PausePooledAIController(AIController);
+	}
 }
 
 void UFireflyObjectPoolLibrary::UniversalBeginPlay_Character(const UObject* WorldContextObject, ACharacter* Character)
@@ -161,6 +560,12 @@ void UFireflyObjectPoolLibrary::UniversalBeginPlay_Character(const UObject* Worl
 
 void UFireflyObjectPoolLibrary::UniversalEndPlay_Character(const UObject* WorldContextObject, ACharacter* Character)
 {
+	Character->StopJumping();
+	if (Character->bIsCrouched)
+	{
+		Character->UnCrouch();
+	}
+
 	UniversalEndPlay_Pawn(WorldContextObject, Character);
 }
 
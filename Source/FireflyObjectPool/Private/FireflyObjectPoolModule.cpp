@@ -2,17 +2,21 @@
 
 #include "FireflyObjectPoolModule.h"
 
+#include "FireflyObjectPoolWorldSubsystem.h"
+
 #define LOCTEXT_NAMESPACE "FFireflyObjectPoolModule"
 
 void FFireflyObjectPoolModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	UFireflyObjectPoolWorldSubsystem::StartupReferenceCollector();
 }
 
 void FFireflyObjectPoolModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	UFireflyObjectPoolWorldSubsystem::ShutdownReferenceCollector();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -2,12 +2,141 @@
 
 #include "FireflyObjectPoolWorldSubsystem.h"
 
+#include "Animation/AnimInstance.h"
+#include "Components/AudioComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SceneComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
 #include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "LatentActions.h"
+#include "Serialization/ArchiveCountMem.h"
 #include "TimerManager.h"
+#include "UObject/GCObject.h"
 
+#include "Blueprint/UserWidget.h"
 
-TMap<TSubclassOf<AActor>, UFireflyObjectPoolWorldSubsystem::TActorPoolList> UFireflyObjectPoolWorldSubsystem::ActorPoolOfClass;
-TMap<FName, UFireflyObjectPoolWorldSubsystem::TActorPoolList> UFireflyObjectPoolWorldSubsystem::ActorPoolOfID;
+#include "NiagaraComponent.h"
+#include "NiagaraSystem.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+
+#include "FireflyActorPoolCluster.h"
+#include "FireflyActorPoolStock.h"
+#include "FireflyObjectPoolLibrary.h"
+#include "FireflyPoolingWidgetInterface.h"
+#include "FireflyPropertyResetCache.h"
+
+
+TMap<TSubclassOf<AActor>, FFireflyActorPool> UFireflyObjectPoolWorldSubsystem::ActorPoolOfClass;
+TMap<FName, FFireflyActorPool> UFireflyObjectPoolWorldSubsystem::ActorPoolOfID;
+TMap<TSubclassOf<UActorComponent>, UFireflyObjectPoolWorldSubsystem::TComponentPoolList> UFireflyObjectPoolWorldSubsystem::ComponentPoolOfClass;
+TMap<TSubclassOf<UUserWidget>, FFireflyWidgetPool> UFireflyObjectPoolWorldSubsystem::WidgetPoolOfClass;
+TMap<TObjectKey<AActor>, FFireflyActiveActorHandle> UFireflyObjectPoolWorldSubsystem::ActiveActorHandles;
+TArray<TObjectKey<AActor>> UFireflyObjectPoolWorldSubsystem::PendingReleaseActors;
+TSet<TObjectKey<AActor>> UFireflyObjectPoolWorldSubsystem::PendingReleaseSet;
+double UFireflyObjectPoolWorldSubsystem::PendingReleaseSecondsPerActor = 0.00002;
+TMap<int32, FFireflyActiveActorHandle> UFireflyObjectPoolWorldSubsystem::LightweightHandles;
+int32 UFireflyObjectPoolWorldSubsystem::NextLightweightID = 0;
+TMap<TObjectKey<UClass>, const FFireflyPoolingNativeHooks*> UFireflyObjectPoolWorldSubsystem::NativeHooksOfClass;
+TMap<TObjectKey<UClass>, const FFireflyPoolingNativeHooks*> UFireflyObjectPoolWorldSubsystem::ResolvedNativeHooksOfClass;
+uint64 UFireflyObjectPoolWorldSubsystem::LastPoolMaintenanceFrame = 0;
+bool UFireflyObjectPoolWorldSubsystem::bPendingTravelAdoption = false;
+
+static TAutoConsoleVariable<float> CVarFireflyObjectPoolReleaseTriggerInterval(
+	TEXT("Firefly.ObjectPool.ReleaseTriggerInterval"),
+	0.1f,
+	TEXT("Interval in seconds between two batched evaluations of the auto-release triggers of actor pools, 0 evaluates every frame."));
+
+static TAutoConsoleVariable<float> CVarFireflyObjectPoolReleaseBudgetMs(
+	TEXT("Firefly.ObjectPool.ReleaseBudgetMs"),
+	2.f,
+	TEXT("Time budget in milliseconds per frame for releasing queued actors back into actor pools."));
+
+static TAutoConsoleVariable<float> CVarFireflyObjectPoolClusterDelay(
+	TEXT("Firefly.ObjectPool.ClusterDelay"),
+	5.f,
+	TEXT("Seconds the actors on standby in a pool must stay unchanged before they are grouped into a GC cluster."));
+
+static TAutoConsoleVariable<int32> CVarFireflyObjectPoolSpawnQueueMaxPerFrame(
+	TEXT("Firefly.ObjectPool.SpawnQueueMaxPerFrame"),
+	8,
+	TEXT("Max number of actors instantiated per frame for queued spawn requests that missed the pool, 0 or less means no cap."));
+
+static TAutoConsoleVariable<float> CVarFireflyObjectPoolSpawnQueueBudgetMs(
+	TEXT("Firefly.ObjectPool.SpawnQueueBudgetMs"),
+	2.f,
+	TEXT("Time budget in milliseconds per frame for processing queued spawn requests."));
+
+static TAutoConsoleVariable<float> CVarFireflyObjectPoolRefillBudgetMs(
+	TEXT("Firefly.ObjectPool.RefillBudgetMs"),
+	1.f,
+	TEXT("Time budget in milliseconds per frame for spawning actors to refill actor pools below their low watermark."));
+
+static TAutoConsoleVariable<float> CVarFireflyObjectPoolDemandSmoothingTime(
+	TEXT("Firefly.ObjectPool.DemandSmoothingTime"),
+	2.f,
+	TEXT("Time constant in seconds of the exponential moving average of the fetch rate of actor pools."));
+
+static TAutoConsoleVariable<float> CVarFireflyObjectPoolDemandLookahead(
+	TEXT("Firefly.ObjectPool.DemandLookahead"),
+	1.f,
+	TEXT("How many seconds of predicted demand actor pools keep on standby above their low watermark."));
+
+static TAutoConsoleVariable<float> CVarFireflyObjectPoolDormantBudgetMB(
+	TEXT("Firefly.ObjectPool.DormantBudgetMB"),
+	0.f,
+	TEXT("Global budget in megabytes of the estimated memory of actors on standby across all actor pools, 0 or less means no budget."));
+
+static TAutoConsoleVariable<float> CVarFireflyObjectPoolEvictBudgetMs(
+	TEXT("Firefly.ObjectPool.EvictBudgetMs"),
+	1.f,
+	TEXT("Time budget in milliseconds per frame for destroying actors on standby while actor pools exceed the global dormant budget."));
+
+static FAutoConsoleCommandWithOutputDevice GFireflyObjectPoolMemReportCommand(
+	TEXT("Firefly.ObjectPool.MemReport"),
+	TEXT("Dump the count and estimated memory of all actor pools."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&UFireflyObjectPoolWorldSubsystem::ActorPool_DumpMemory));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GFireflyObjectPoolBenchmarkSpawnCommand(
+	TEXT("Firefly.ObjectPool.BenchmarkSpawn"),
+	TEXT("Usage: Firefly.ObjectPool.BenchmarkSpawn <ActorClassPath> [Count]. Compare the per-spawn cost of spawning from class defaults and from a template instance."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&UFireflyObjectPoolWorldSubsystem::ActorPool_BenchmarkSpawn));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GFireflyObjectPoolBenchmarkGCCommand(
+	TEXT("Firefly.ObjectPool.BenchmarkGC"),
+	TEXT("Usage: Firefly.ObjectPool.BenchmarkGC [Iterations]. Compare the full garbage collection time with and without the actors on standby clustered."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&UFireflyObjectPoolWorldSubsystem::ActorPool_BenchmarkGC));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GFireflyObjectPoolBenchmarkCharacterWaveCommand(
+	TEXT("Firefly.ObjectPool.BenchmarkCharacterWave"),
+	TEXT("Usage: Firefly.ObjectPool.BenchmarkCharacterWave <CharacterClassPath> [Count] [Waves]. Compare the per-character cost of spawning a wave fresh and of reactivating it from the pool, and of resetting the anim instance against reinitializing it."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&UFireflyObjectPoolWorldSubsystem::ActorPool_BenchmarkCharacterWave));
+
+/** 向垃圾回收报告静态对象池中所有引用的对象 */
+/** Object reporting all references held by the static pools to garbage collection */
+class FFireflyObjectPoolReferenceCollector : public FGCObject
+{
+public:
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+	{
+		UFireflyObjectPoolWorldSubsystem::AddPoolReferences(Collector);
+	}
+
+	virtual FString GetReferencerName() const override
+	{
+		return TEXT("FFireflyObjectPoolReferenceCollector");
+	}
+};
+
+static TUniquePtr<FFireflyObjectPoolReferenceCollector> GFireflyObjectPoolReferenceCollector;
 
 
 void UFireflyObjectPoolWorldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
@@ -17,304 +146,4023 @@ void UFireflyObjectPoolWorldSubsystem::Initialize(FSubsystemCollectionBase& Coll
 
 void UFireflyObjectPoolWorldSubsystem::Deinitialize()
 {
-	ActorPool_ClearAll();
+	PendingSpawnRequests.Empty();
+	if (GetWorld()->IsInSeamlessTravel())
+	{
+		ActorPool_ClearForSeamlessTravel();
+	}
+	else
+	{
+		ActorPool_ClearAll();
+	}
+	ComponentPool_ClearAll();
+	WidgetPool_ClearAll();
 
 	Super::Deinitialize();
 }
 
+void UFireflyObjectPoolWorldSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!GetWorld()->IsGameWorld())
+	{
+		return;
+	}
+
+	const bool bMaintainPools = LastPoolMaintenanceFrame != GFrameCounter;
+	LastPoolMaintenanceFrame = GFrameCounter;
+
+	ProcessPendingReleases();
+	ProcessSpawnRequests();
+	if (bMaintainPools)
+	{
+		RefillPools(DeltaTime);
+		EvictOverBudgetPools();
+	}
+	UpdatePoolClusters(DeltaTime);
+
+	ReleaseTriggerCountdown -= DeltaTime;
+	if (ReleaseTriggerCountdown <= 0.f)
+	{
+		ReleaseTriggerCountdown = CVarFireflyObjectPoolReleaseTriggerInterval.GetValueOnGameThread();
+		EvaluateReleaseTriggers();
+		EvaluateLightweightRelevance();
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	AdoptTravelledPools();
+}
+
+TStatId UFireflyObjectPoolWorldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFireflyObjectPoolWorldSubsystem, STATGROUP_Tickables);
+}
+
 void UFireflyObjectPoolWorldSubsystem::ActorPool_ClearAll()
 {
-	for (auto Pool : ActorPoolOfClass)
+	for (auto& Pool : ActorPoolOfClass)
 	{
-		for (auto Actor : Pool.Value)
+		for (auto Actor : Pool.Value.Actors)
 		{
 			if (IsValid(Actor))
 			{
 				Actor->Destroy(true);
 			}
 		}
+
+		if (IsValid(Pool.Value.TemplateActor))
+		{
+			Pool.Value.TemplateActor->Destroy(true);
+		}
+		ClearLightweights(Pool.Value);
+		DissolvePoolCluster(Pool.Value);
 	}
 
-	for (auto Pool : ActorPoolOfID)
+	for (auto& Pool : ActorPoolOfID)
 	{
-		for (auto Actor : Pool.Value)
+		for (auto Actor : Pool.Value.Actors)
 		{
 			if (IsValid(Actor))
 			{
 				Actor->Destroy(true);
 			}
 		}
+
+		if (IsValid(Pool.Value.TemplateActor))
+		{
+			Pool.Value.TemplateActor->Destroy(true);
+		}
+		ClearLightweights(Pool.Value);
+		DissolvePoolCluster(Pool.Value);
 	}
 
 	ActorPoolOfClass.Empty();
 	ActorPoolOfID.Empty();
+	ActiveActorHandles.Empty();
+	LightweightHandles.Empty();
+	PendingReleaseActors.Empty();
+	PendingReleaseSet.Empty();
+	FFireflyPropertyResetCache::ClearAll();
 }
 
 void UFireflyObjectPoolWorldSubsystem::ActorPool_ClearByClass(TSubclassOf<AActor> ActorClass)
 {
-	if (TActorPoolList* Pool = ActorPoolOfClass.Find(ActorClass))
+	if (FFireflyActorPool* Pool = ActorPoolOfClass.Find(ActorClass))
 	{
-		for (auto Actor : *Pool)
+		for (auto Actor : Pool->Actors)
 		{
 			if (IsValid(Actor))
 			{
 				Actor->Destroy(true);
 			}
 		}
-		Pool->Empty();
+		if (IsValid(Pool->TemplateActor))
+		{
+			Pool->TemplateActor->Destroy(true);
+		}
+		for (const FFireflyActiveActorRecord& Record : Pool->ActiveActors)
+		{
+			ActiveActorHandles.Remove(Record.Actor.Get());
+		}
+		ClearLightweights(*Pool);
+		DissolvePoolCluster(*Pool);
+		Pool->Actors.Empty();
 		ActorPoolOfClass.Remove(ActorClass);
 	}
 }
 
 void UFireflyObjectPoolWorldSubsystem::ActorPool_ClearByID(FName ActorID)
 {
-	if (TActorPoolList* Pool = ActorPoolOfID.Find(ActorID))
+	if (FFireflyActorPool* Pool = ActorPoolOfID.Find(ActorID))
 	{
-		for (auto Actor : *Pool)
+		for (auto Actor : Pool->Actors)
 		{
 			if (IsValid(Actor))
 			{
 				Actor->Destroy(true);
 			}
 		}
-		Pool->Empty();
+		if (IsValid(Pool->TemplateActor))
+		{
+			Pool->TemplateActor->Destroy(true);
+		}
+		for (const FFireflyActiveActorRecord& Record : Pool->ActiveActors)
+		{
+			ActiveActorHandles.Remove(Record.Actor.Get());
+		}
+		ClearLightweights(*Pool);
+		DissolvePoolCluster(*Pool);
+		Pool->Actors.Empty();
 		ActorPoolOfID.Remove(ActorID);
 	}
 }
 
-AActor* UFireflyObjectPoolWorldSubsystem::K2_ActorPool_FetchActor(TSubclassOf<AActor> ActorClass, FName ActorID)
+void UFireflyObjectPoolWorldSubsystem::ActorPool_GetSeamlessTravelActors(const UObject* WorldContextObject,
+	TArray<AActor*>& ActorList)
 {
-	return ActorPool_FetchActor<AActor>(ActorClass, ActorID);
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	auto AddPool = [World, &ActorList](const FFireflyActorPool& Pool)
+	{
+		if (!Pool.Config.bKeepAcrossSeamlessTravel)
+		{
+			return;
+		}
+
+		for (AActor* Actor : Pool.Actors)
+		{
+			if (IsValid(Actor) && Actor->GetWorld() == World)
+			{
+				ActorList.AddUnique(Actor);
+			}
+		}
+
+		if (IsValid(Pool.TemplateActor) && Pool.TemplateActor->GetWorld() == World)
+		{
+			ActorList.AddUnique(Pool.TemplateActor);
+		}
+	};
+
+	for (const auto& Pool : ActorPoolOfClass)
+	{
+		AddPool(Pool.Value);
+	}
+
+	for (const auto& Pool : ActorPoolOfID)
+	{
+		AddPool(Pool.Value);
+	}
 }
 
-TArray<AActor*> UFireflyObjectPoolWorldSubsystem::K2_ActorPool_FetchActors(TSubclassOf<AActor> ActorClass, FName ActorID,
-                                                                           int32 Count)
+void UFireflyObjectPoolWorldSubsystem::ActorPool_WarmUpToCount(const UObject* WorldContextObject,
+	TSubclassOf<AActor> ActorClass, FName ActorID, const FTransform& Transform, int32 TargetCount)
 {
-	return ActorPool_FetchActors<AActor>(ActorClass, ActorID, Count);
+	const FFireflyActorPool* Pool = ActorID != NAME_None ? ActorPoolOfID.Find(ActorID) : ActorPoolOfClass.Find(ActorClass);
+	const int32 Count = TargetCount - (Pool ? Pool->Actors.Num() : 0);
+	if (Count > 0)
+	{
+		ActorPool_WarmUp(WorldContextObject, ActorClass, ActorID, Transform, nullptr, nullptr, Count);
+	}
 }
 
-AActor* UFireflyObjectPoolWorldSubsystem::SpawnActor_Internal(TSubclassOf<AActor> ActorClass, FName ActorID,
-	const FTransform& Transform, float Lifetime, AActor* Owner, APawn* Instigator,
-	const ESpawnActorCollisionHandlingMethod CollisionHandling)
+void UFireflyObjectPoolWorldSubsystem::ActorPool_AdoptBakedStock(AFireflyActorPoolStock* Stock)
 {
-	UWorld* World = GetWorld();
-	if (!IsValid(World) || (!IsValid(ActorClass) && ActorID == NAME_None))
+	if (!IsValid(Stock))
 	{
-		return nullptr;
+		return;
 	}
 
-	AActor* Actor = ActorPool_FetchActor<AActor>(ActorClass, ActorID);
-	if (Actor)
+	for (FFireflyActorPoolStockEntry& Entry : Stock->Entries)
 	{
-		Actor->SetActorTransform(Transform, true, nullptr, ETeleportType::ResetPhysics);
-		Actor->SetOwner(Owner);
+		if (!IsValid(Entry.ActorClass) || Entry.BakedActors.Num() == 0)
+		{
+			continue;
+		}
+
+		FFireflyActorPool& Pool = Entry.ActorID != NAME_None ? ActorPoolOfID.FindOrAdd(Entry.ActorID) : ActorPoolOfClass.FindOrAdd(Entry.ActorClass);
+		Pool.ActorClass = Entry.ActorClass;
+		MarkPoolStockChanged(Pool);
 
-		if (Actor->template Implements<UFireflyPoolingActorInterface>())
+		for (AActor* Actor : Entry.BakedActors)
 		{
-			if (IFireflyPoolingActorInterface::Execute_PoolingGetActorID(Actor) != ActorID && ActorID != NAME_None)
+			if (!IsValid(Actor))
+			{
+				continue;
+			}
+
+			if (Pool.Actors.Num() >= Pool.GetCapacity())
+			{
+				Actor->Destroy(true);
+				continue;
+			}
+
+			// 保存的状态已经是待命状态，这里只补上不会被保存的运行时状态（如Tick）。
+			// The saved state is already dormant, only the runtime state that isn't saved (such as ticking) is applied here.
+			if (Pool.Config.bStripCosmeticsOnServer)
+			{
+				UFireflyObjectPoolLibrary::StripCosmeticComponents(Stock, Actor);
+			}
+			UFireflyObjectPoolLibrary::UniversalWarmUp_Actor(Stock, Actor);
+			if (Entry.ActorID != NAME_None)
 			{
-				IFireflyPoolingActorInterface::Execute_PoolingSetActorID(Actor, ActorID);
+				Pooling_SetActorID(Actor, Entry.ActorID);
 			}
-			IFireflyPoolingActorInterface::Execute_PoolingBeginPlay(Actor);
+			Pooling_WarmUp(Actor);
+
+			SamplePool(Pool, Actor);
+			Pool.PushActor(Actor);
 		}
+
+		Entry.BakedActors.Empty();
 	}
-	else
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_ClearForSeamlessTravel()
+{
+	TArray<TSubclassOf<AActor>> ClassesToClear;
+	for (auto& Pool : ActorPoolOfClass)
 	{
-		if (!IsValid(ActorClass))
+		if (!Pool.Value.Config.bKeepAcrossSeamlessTravel)
 		{
-			return nullptr;
+			ClassesToClear.Add(Pool.Key);
 		}
+	}
 
-		FActorSpawnParameters SpawnParameters;
-		SpawnParameters.Owner = Owner;
-		SpawnParameters.Instigator = Instigator;
-		SpawnParameters.SpawnCollisionHandlingOverride = CollisionHandling;
+	TArray<FName> IDsToClear;
+	for (auto& Pool : ActorPoolOfID)
+	{
+		if (!Pool.Value.Config.bKeepAcrossSeamlessTravel)
+		{
+			IDsToClear.Add(Pool.Key);
+		}
+	}
+
+	for (const TSubclassOf<AActor>& ActorClass : ClassesToClear)
+	{
+		ActorPool_ClearByClass(ActorClass);
+	}
+
+	for (const FName& ActorID : IDsToClear)
+	{
+		ActorPool_ClearByID(ActorID);
+	}
 
-		Actor = World->SpawnActor<AActor>(ActorClass, Transform, SpawnParameters);
-		if (Actor->template Implements<UFireflyPoolingActorInterface>())
+	// 保留的对象池只留下待命Actor和模板实例，正在使用的Actor和依附于旧世界的数据随旧世界一起销毁。
+	// The kept pools only retain the Actors on standby and the template instance, Actors in use and data tied to the old world are destroyed with it.
+	auto ResetPool = [](FFireflyActorPool& Pool)
+	{
+		for (int32 i = 0; i < Pool.BatchedProjectiles.Num(); ++i)
 		{
-			if (ActorID != NAME_None)
-			{
-				IFireflyPoolingActorInterface::Execute_PoolingSetActorID(Actor, ActorID);
-			}
-			IFireflyPoolingActorInterface::Execute_PoolingBeginPlay(Actor);
+			SetProjectileBatched(Pool, i, false);
 		}
+		Pool.BatchedProjectiles.SetNum(0);
+		Pool.TickFunction.Reset();
+		Pool.ActiveActors.Empty();
+		ClearLightweights(Pool);
+		MarkPoolStockChanged(Pool);
+	};
+
+	for (auto& Pool : ActorPoolOfClass)
+	{
+		ResetPool(Pool.Value);
 	}
 
-	if (IsValid(Actor) && Lifetime > 0.f)
+	for (auto& Pool : ActorPoolOfID)
 	{
-		FTimerHandle TimerHandle;
-		auto TimerLambda = [Actor]() { ActorPool_ReleaseActor(Actor); };
-		World->GetTimerManager().SetTimer(TimerHandle, TimerLambda, Lifetime, false);
+		ResetPool(Pool.Value);
 	}
 
-	return Actor;
+	ActiveActorHandles.Empty();
+	LightweightHandles.Empty();
+	PendingReleaseActors.Empty();
+	PendingReleaseSet.Empty();
+
+	bPendingTravelAdoption = true;
 }
 
-AActor* UFireflyObjectPoolWorldSubsystem::ActorPool_BeginDeferredActorSpawn(const UObject* WorldContext, TSubclassOf<AActor> ActorClass
-	, FName ActorID, const FTransform& SpawnTransform, AActor* Owner, ESpawnActorCollisionHandlingMethod CollisionHandling)
+void UFireflyObjectPoolWorldSubsystem::AdoptTravelledPools()
 {
-	UWorld* World = WorldContext->GetWorld();
-	if (!IsValid(World) || (!IsValid(ActorClass) && ActorID == NAME_None))
+	// 其他世界（如另一个PIE实例）开始游戏时不能丢弃不属于它的待命Actor。
+	// Other worlds (such as another PIE instance) beginning play must not drop the Actors on standby that don't belong to them.
+	if (!bPendingTravelAdoption || !GetWorld()->IsGameWorld())
 	{
-		return nullptr;
+		return;
 	}
+	bPendingTravelAdoption = false;
 
-	auto SetActorID = [ActorID](AActor* InActor)
+	UWorld* World = GetWorld();
+	auto AdoptPool = [World](FFireflyActorPool& Pool)
 	{
-		if (InActor->Implements<UFireflyPoolingActorInterface>())
+		if (!Pool.Config.bKeepAcrossSeamlessTravel)
+		{
+			return;
+		}
+
+		const int32 NumActors = Pool.Actors.Num();
+		for (int32 i = NumActors - 1; i >= 0; --i)
 		{
-			if (IFireflyPoolingActorInterface::Execute_PoolingGetActorID(InActor) != ActorID && ActorID != NAME_None)
+			AActor* Actor = Pool.Actors[i];
+			if (!IsValid(Actor) || Actor->GetWorld() != World)
 			{
-				IFireflyPoolingActorInterface::Execute_PoolingSetActorID(InActor, ActorID);
+				Pool.RemoveActorAt(i);
+				if (IsValid(Actor))
+				{
+					Actor->Destroy(true);
+				}
 			}
 		}
+		if (Pool.Actors.Num() != NumActors)
+		{
+			MarkPoolStockChanged(Pool);
+		}
+
+		if (!IsValid(Pool.TemplateActor) || Pool.TemplateActor->GetWorld() != World)
+		{
+			if (IsValid(Pool.TemplateActor))
+			{
+				Pool.TemplateActor->Destroy(true);
+			}
+			Pool.TemplateActor = nullptr;
+		}
 	};
 
-	AActor* Actor = ActorPool_FetchActor<AActor>(ActorClass, ActorID);
-	if (Actor)
+	for (auto& Pool : ActorPoolOfClass)
 	{
-		SetActorID(Actor);
-		Actor->SetActorTransform(SpawnTransform, true, nullptr, ETeleportType::ResetPhysics);
-		Actor->SetOwner(Owner);
+		AdoptPool(Pool.Value);
+	}
 
-		return Actor;
+	for (auto& Pool : ActorPoolOfID)
+	{
+		AdoptPool(Pool.Value);
 	}
+}
 
+void UFireflyObjectPoolWorldSubsystem::ActorPool_SetConfigOfClass(TSubclassOf<AActor> ActorClass,
+	const FFireflyActorPoolConfig& Config)
+{
 	if (!IsValid(ActorClass))
 	{
-		return nullptr;
+		return;
 	}
 
-	UObject* MutableWorldContext = const_cast<UObject*>(WorldContext);
-	APawn* AutoInstigator = Cast<APawn>(MutableWorldContext);
-	Actor = World->SpawnActorDeferred<AActor>(ActorClass, SpawnTransform, Owner, AutoInstigator, CollisionHandling);
-	SetActorID(Actor);
-
-	return Actor;
+	FFireflyActorPool& Pool = ActorPoolOfClass.FindOrAdd(ActorClass);
+	const bool bWasIndexed = Pool.Config.bIndexVariants;
+	Pool.Config = Config;
+	if (Pool.Config.bIndexVariants != bWasIndexed)
+	{
+		Pool.RebuildVariantIndex();
+	}
+	TrimPool_Internal(Pool, Pool.GetCapacity());
+	ApplyBatchedProjectileConfig(Pool, ActorClass, NAME_None, nullptr);
 }
 
-AActor* UFireflyObjectPoolWorldSubsystem::ActorPool_FinishSpawningActor(const UObject* WorldContext, AActor* Actor
-	, const FTransform& SpawnTransform, float Lifetime)
+void UFireflyObjectPoolWorldSubsystem::ActorPool_SetConfigOfID(FName ActorID, const FFireflyActorPoolConfig& Config)
 {
-	UWorld* World = WorldContext->GetWorld();
-	if (!IsValid(World) || !IsValid(Actor))
+	if (ActorID == NAME_None)
 	{
-		return nullptr;
+		return;
 	}
 
-	if ((!Actor->IsActorInitialized()))
+	FFireflyActorPool& Pool = ActorPoolOfID.FindOrAdd(ActorID);
+	const bool bWasIndexed = Pool.Config.bIndexVariants;
+	Pool.Config = Config;
+	if (Pool.Config.bIndexVariants != bWasIndexed)
 	{
-		Actor->FinishSpawning(SpawnTransform);
+		Pool.RebuildVariantIndex();
 	}
+	TrimPool_Internal(Pool, Pool.GetCapacity());
+	ApplyBatchedProjectileConfig(Pool, nullptr, ActorID, nullptr);
+}
 
-	if (Actor->Implements<UFireflyPoolingActorInterface>())
+void UFireflyObjectPoolWorldSubsystem::ActorPool_TrimByClass(TSubclassOf<AActor> ActorClass, int32 KeepCount,
+	float KeepMegabytes)
+{
+	FFireflyActorPool* Pool = ActorPoolOfClass.Find(ActorClass);
+	if (!Pool)
 	{
-		IFireflyPoolingActorInterface::Execute_PoolingBeginPlay(Actor);
+		return;
 	}
 
-	if (Lifetime > 0.f)
+	SamplePool(*Pool);
+	if (KeepMegabytes >= 0.f && Pool->SampledActorBytes > 0)
 	{
-		FTimerHandle TimerHandle;
-		auto TimerLambda = [Actor]() { ActorPool_ReleaseActor(Actor); };
-		World->GetTimerManager().SetTimer(TimerHandle, TimerLambda, Lifetime, false);
+		const int32 KeepCountByMemory = static_cast<int64>(KeepMegabytes * 1024.f * 1024.f) / Pool->SampledActorBytes;
+		KeepCount = KeepCount >= 0 ? FMath::Min(KeepCount, KeepCountByMemory) : KeepCountByMemory;
 	}
 
-	return Actor;
+	if (KeepCount >= 0)
+	{
+		TrimPool_Internal(*Pool, KeepCount);
+	}
 }
 
-void UFireflyObjectPoolWorldSubsystem::ActorPool_ReleaseActor(AActor* Actor)
+void UFireflyObjectPoolWorldSubsystem::ActorPool_TrimByID(FName ActorID, int32 KeepCount, float KeepMegabytes)
 {
-	if (!IsValid(Actor))
+	FFireflyActorPool* Pool = ActorPoolOfID.Find(ActorID);
+	if (!Pool)
 	{
 		return;
 	}
 
-	FName ActorID = NAME_None;
-	if (Actor->Implements<UFireflyPoolingActorInterface>())
+	SamplePool(*Pool);
+	if (KeepMegabytes >= 0.f && Pool->SampledActorBytes > 0)
 	{
-		ActorID = IFireflyPoolingActorInterface::Execute_PoolingGetActorID(Actor);
-		IFireflyPoolingActorInterface::Execute_PoolingEndPlay(Actor);
+		const int32 KeepCountByMemory = static_cast<int64>(KeepMegabytes * 1024.f * 1024.f) / Pool->SampledActorBytes;
+		KeepCount = KeepCount >= 0 ? FMath::Min(KeepCount, KeepCountByMemory) : KeepCountByMemory;
 	}
 
-	if (ActorID != NAME_None)
+	if (KeepCount >= 0)
 	{
-		TActorPoolList& Pool = ActorPoolOfID.FindOrAdd(ActorID);
-		Pool.Push(Actor);
-
-		return;
+		TrimPool_Internal(*Pool, KeepCount);
 	}
-
-	TActorPoolList& Pool = ActorPoolOfClass.FindOrAdd(Actor->GetClass());	
-	Pool.Push(Actor);	
 }
 
-void UFireflyObjectPoolWorldSubsystem::ActorPool_WarmUp(const UObject* WorldContextObject,
-	TSubclassOf<AActor> ActorClass, FName ActorID, const FTransform& Transform, AActor* Owner, APawn* Instigator,
-	int32 Count)
+void UFireflyObjectPoolWorldSubsystem::TrimPool_Internal(FFireflyActorPool& Pool, int32 KeepCount)
 {
-	UWorld* World = WorldContextObject->GetWorld();
-
-	if (!IsValid(World) || !IsValid(ActorClass) || ActorID == NAME_None || Count <= 0)
+	if (Pool.Actors.Num() > FMath::Max(KeepCount, 0))
 	{
-		return;
+		MarkPoolStockChanged(Pool);
 	}
 
-	FActorSpawnParameters SpawnParameters;
-	SpawnParameters.Owner = Owner;
-	SpawnParameters.Instigator = Instigator;
-	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-
-	TActorPoolList& Pool = ActorID != NAME_None ? ActorPoolOfID.FindOrAdd(ActorID) : ActorPoolOfClass.FindOrAdd(ActorClass);
-	Pool.Reserve(Count);
-	for (int32 i = 0; i < Count; i++)
+	while (Pool.Actors.Num() > FMath::Max(KeepCount, 0))
 	{
-		AActor* Actor = World->SpawnActor<AActor>(ActorClass, Transform, SpawnParameters);
-		if (Actor->Implements<UFireflyPoolingActorInterface>())
+		AActor* Actor = Pool.PopActor();
+		if (IsValid(Actor))
 		{
-			if (ActorID != NAME_None)
-			{
-				IFireflyPoolingActorInterface::Execute_PoolingSetActorID(Actor, ActorID);
-			}
-			IFireflyPoolingActorInterface::Execute_PoolingWarmUp(Actor);
+			Actor->Destroy(true);
 		}
-
-		Pool.Push(Actor);
 	}
 }
 
-TArray<TSubclassOf<AActor>> UFireflyObjectPoolWorldSubsystem::ActorPool_DebugActorClasses()
+int64 UFireflyObjectPoolWorldSubsystem::GetTotalDormantBytes()
 {
-	TArray<TSubclassOf<AActor>> ActorClasses;
-	ActorPoolOfClass.GetKeys(ActorClasses);
-
-	return ActorClasses;
-}
+	int64 TotalBytes = 0;
+	for (const auto& Pool : ActorPoolOfClass)
+	{
+		TotalBytes += Pool.Value.GetEstimatedBytes();
+	}
 
-TArray<FName> UFireflyObjectPoolWorldSubsystem::ActorPool_DebugActorIDs()
-{
-	TArray<FName> ActorIDs;
-	ActorPoolOfID.GetKeys(ActorIDs);
+	for (const auto& Pool : ActorPoolOfID)
+	{
+		TotalBytes += Pool.Value.GetEstimatedBytes();
+	}
 
-	return ActorIDs;
+	return TotalBytes;
 }
 
-int32 UFireflyObjectPoolWorldSubsystem::ActorPool_DebugActorNumberOfClass(TSubclassOf<AActor> ActorClass)
+void UFireflyObjectPoolWorldSubsystem::EvictOverBudgetPools()
 {
-	if (!ActorPoolOfClass.Contains(ActorClass))
+	const float BudgetMegabytes = CVarFireflyObjectPoolDormantBudgetMB.GetValueOnGameThread();
+	if (BudgetMegabytes <= 0.f)
 	{
-		return -1;
+		return;
 	}
 
-	return ActorPoolOfClass[ActorClass].Num();
-}
+	const int64 BudgetBytes = static_cast<int64>(BudgetMegabytes * 1024.f * 1024.f);
+	int64 TotalBytes = GetTotalDormantBytes();
+	if (TotalBytes <= BudgetBytes)
+	{
+		return;
+	}
 
-int32 UFireflyObjectPoolWorldSubsystem::ActorPool_DebugActorNumberOfID(FName ActorID)
-{
-	if (!ActorPoolOfID.Contains(ActorID))
+	// 销毁Actor不会修改对象池映射，所以这里可以持有对象池的指针。
+	// Destroying Actors doesn't modify the pool maps, so pointers to the pools can be held here.
+	TArray<FFireflyActorPool*> Candidates;
+	auto CollectPool = [&Candidates](FFireflyActorPool& Pool)
 	{
-		return -1;
+		if (Pool.Actors.Num() == 0 || Pool.SampledActorBytes <= 0)
+		{
+			return;
+		}
+
+		if (Pool.Config.Priority > 0 && Pool.ActiveActors.Num() > 0)
+		{
+			return;
+		}
+
+		Candidates.Add(&Pool);
+	};
+
+	for (auto& Pool : ActorPoolOfClass)
+	{
+		CollectPool(Pool.Value);
 	}
 
-	return ActorPoolOfID[ActorID].Num();
+	for (auto& Pool : ActorPoolOfID)
+	{
+		CollectPool(Pool.Value);
+	}
+
+	Candidates.Sort([](const FFireflyActorPool& A, const FFireflyActorPool& B)
+	{
+		return A.Config.Priority != B.Config.Priority ? A.Config.Priority < B.Config.Priority : A.LastUsedFrame < B.LastUsedFrame;
+	});
+
+	const double EndTime = FPlatformTime::Seconds() + CVarFireflyObjectPoolEvictBudgetMs.GetValueOnGameThread() / 1000.0;
+	for (FFireflyActorPool* Pool : Candidates)
+	{
+		if (TotalBytes <= BudgetBytes || FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+
+		MarkPoolStockChanged(*Pool);
+		while (Pool->Actors.Num() > 0 && TotalBytes > BudgetBytes && FPlatformTime::Seconds() < EndTime)
+		{
+			AActor* Actor = Pool->PopActor();
+			if (IsValid(Actor))
+			{
+				Actor->Destroy(true);
+			}
+			TotalBytes -= Pool->SampledActorBytes;
+		}
+	}
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::K2_ActorPool_FetchActor(TSubclassOf<AActor> ActorClass, FName ActorID)
+{
+	return ActorPool_FetchActor<AActor>(ActorClass, ActorID);
+}
+
+TArray<AActor*> UFireflyObjectPoolWorldSubsystem::K2_ActorPool_FetchActors(TSubclassOf<AActor> ActorClass, FName ActorID,
+                                                                           int32 Count)
+{
+	return ActorPool_FetchActors<AActor>(ActorClass, ActorID, Count);
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::SpawnActor_Internal(TSubclassOf<AActor> ActorClass, FName ActorID,
+	const FTransform& Transform, float Lifetime, AActor* Owner, APawn* Instigator,
+	const ESpawnActorCollisionHandlingMethod CollisionHandling, bool bSweep, FName Variant, FName* OutPreviousVariant)
+{
+	UWorld* World = GetWorld();
+	if (!IsValid(World) || (!IsValid(ActorClass) && ActorID == NAME_None))
+	{
+		return nullptr;
+	}
+
+	FName PreviousVariant = NAME_None;
+	AActor* Actor = Variant != NAME_None
+		? FetchActorOfVariant_Internal(ActorClass, ActorID, Variant, PreviousVariant)
+		: ActorPool_FetchActor<AActor>(ActorClass, ActorID);
+	if (!Actor)
+	{
+		Actor = BorrowActor_Internal(ActorClass, ActorID);
+	}
+
+	auto Activate = [Lifetime, Variant](AActor* InActor, AActor* InOwner)
+	{
+		Pooling_BeginPlay(InActor);
+		TrackActiveActor(InActor, InOwner);
+		if (Variant != NAME_None)
+		{
+			SetActiveVariant(InActor, Variant);
+		}
+		SetActorLifetime_Internal(InActor, Lifetime);
+	};
+
+	if (Actor)
+	{
+		TeleportFetchedActor(Actor, Transform, bSweep);
+		Actor->SetOwner(Owner);
+
+		if (Pooling_GetActorID(Actor) != ActorID && ActorID != NAME_None)
+		{
+			Pooling_SetActorID(Actor, ActorID);
+		}
+		if (!DeferFetchedActivation(Actor, Owner, Activate))
+		{
+			Activate(Actor, Owner);
+		}
+	}
+	else
+	{
+		if (!IsValid(ActorClass))
+		{
+			return nullptr;
+		}
+
+		Actor = SpawnNewActor_Internal(World, ActorClass, ActorID, Transform, Owner, Instigator, CollisionHandling);
+		if (IsValid(Actor))
+		{
+			if (ActorID != NAME_None)
+			{
+				Pooling_SetActorID(Actor, ActorID);
+			}
+			Activate(Actor, Owner);
+		}
+	}
+
+	if (OutPreviousVariant)
+	{
+		*OutPreviousVariant = PreviousVariant;
+	}
+
+	return Actor;
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::FetchActorOfVariant_Internal(TSubclassOf<AActor> ActorClass, FName ActorID,
+	FName Variant, FName& OutPreviousVariant)
+{
+	OutPreviousVariant = NAME_None;
+
+	FFireflyActorPool* Pool = ActorPoolOfID.Find(ActorID);
+	const bool bPoolOfID = Pool != nullptr;
+	if (!Pool)
+	{
+		Pool = ActorPoolOfClass.Find(ActorClass);
+	}
+
+	if (!Pool || !Pool->Config.bIndexVariants)
+	{
+		return ActorPool_FetchActor<AActor>(ActorClass, ActorID);
+	}
+
+	if (Pool->Actors.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	MarkPoolStockChanged(*Pool);
+	AActor* Actor = Pool->PopActorOfVariant(Variant, OutPreviousVariant);
+	if (Actor)
+	{
+		TrackActiveActor(*Pool, bPoolOfID ? nullptr : ActorClass.Get(), bPoolOfID ? ActorID : NAME_None, Actor, Actor->GetOwner());
+		SetActiveVariant(Actor, Variant);
+	}
+
+	return Actor;
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::ActorPool_SpawnActorOfVariant(const UObject* WorldContextObject,
+	TSubclassOf<AActor> ActorClass, FName ActorID, FName Variant, const FTransform& Transform, FName& PreviousVariant,
+	float Lifetime, AActor* Owner, APawn* Instigator)
+{
+	PreviousVariant = NAME_None;
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UFireflyObjectPoolWorldSubsystem* Subsystem = IsValid(World) ? World->GetSubsystem<UFireflyObjectPoolWorldSubsystem>() : nullptr;
+	if (!Subsystem)
+	{
+		return nullptr;
+	}
+
+	return Subsystem->SpawnActor_Internal(ActorClass, ActorID, Transform, Lifetime, Owner, Instigator
+		, ESpawnActorCollisionHandlingMethod::AlwaysSpawn, false, Variant, &PreviousVariant);
+}
+
+void UFireflyObjectPoolWorldSubsystem::SetActorLifetime_Internal(AActor* Actor, float Lifetime)
+{
+	if (Lifetime <= 0.f)
+	{
+		return;
+	}
+
+	// 计时器句柄保存在活跃记录中，Actor提前回收时清除计时器，避免它在下一次被取出后被提前回收。
+	// The timer handle is kept in the active record and cleared when the Actor is released early, so it doesn't release the Actor after its next fetch.
+	FTimerHandle LocalTimerHandle;
+	FTimerHandle* TimerHandle = &LocalTimerHandle;
+	const FFireflyActiveActorHandle* Handle = ActiveActorHandles.Find(Actor);
+	FFireflyActorPool* Pool = Handle
+		? (Handle->PoolID != NAME_None ? ActorPoolOfID.Find(Handle->PoolID) : ActorPoolOfClass.Find(Handle->PoolClass))
+		: nullptr;
+	if (Pool && Pool->ActiveActors.IsValidIndex(Handle->Index))
+	{
+		TimerHandle = &Pool->ActiveActors[Handle->Index].LifetimeTimer;
+	}
+
+	TWeakObjectPtr<AActor> WeakActor(Actor);
+	auto TimerLambda = [WeakActor]()
+	{
+		if (AActor* PooledActor = WeakActor.Get())
+		{
+			ActorPool_ReleaseActor(PooledActor);
+		}
+	};
+	Actor->GetWorld()->GetTimerManager().SetTimer(*TimerHandle, TimerLambda, Lifetime, false);
+}
+
+bool UFireflyObjectPoolWorldSubsystem::DeferFetchedActivation(AActor* Actor, AActor* Owner,
+	TFunction<void(AActor*, AActor*)> Activation)
+{
+	TWeakObjectPtr<AActor> WeakActor(Actor);
+	TWeakObjectPtr<AActor> WeakOwner(Owner);
+	auto DeferredActivation = [WeakActor, WeakOwner, Activation = MoveTemp(Activation)]()
+	{
+		AActor* FetchedActor = WeakActor.Get();
+		if (IsValid(FetchedActor) && ActiveActorHandles.Contains(FetchedActor))
+		{
+			Activation(FetchedActor, WeakOwner.Get());
+		}
+	};
+	if (!FFireflyScopedActorPoolBatch::DeferActivation(MoveTemp(DeferredActivation)))
+	{
+		return false;
+	}
+
+	// 先记录Actor，使它在激活之前被回收时能正常移出活跃集合。
+	// Track the Actor first, so releasing it before activation removes it from the active set properly.
+	TrackActiveActor(Actor, Owner);
+
+	return true;
+}
+
+void UFireflyObjectPoolWorldSubsystem::TeleportFetchedActor(AActor* Actor, const FTransform& Transform, bool bSweep)
+{
+	FFireflyScopedActorPoolBatch::DeferMovementUpdates(Actor->GetRootComponent());
+	Actor->SetActorTransform(Transform, bSweep, nullptr, ETeleportType::ResetPhysics);
+}
+
+TArray<AActor*> UFireflyObjectPoolWorldSubsystem::ActorPool_SpawnActorsBatched(const UObject* WorldContextObject,
+	TSubclassOf<AActor> ActorClass, FName ActorID, const TArray<FTransform>& Transforms, float Lifetime,
+	AActor* Owner, APawn* Instigator)
+{
+	TArray<AActor*> Actors;
+	UWorld* World = WorldContextObject->GetWorld();
+	UFireflyObjectPoolWorldSubsystem* Subsystem = IsValid(World) ? World->GetSubsystem<UFireflyObjectPoolWorldSubsystem>() : nullptr;
+	if (!Subsystem)
+	{
+		return Actors;
+	}
+
+	Actors.Reserve(Transforms.Num());
+	{
+		FFireflyScopedActorPoolBatch Batch;
+		for (const FTransform& Transform : Transforms)
+		{
+			if (AActor* Actor = Subsystem->SpawnActor_Internal(ActorClass, ActorID, Transform, Lifetime, Owner, Instigator))
+			{
+				Actors.Add(Actor);
+			}
+		}
+	}
+
+	return Actors;
+}
+
+/** 等待异步生成请求完成的蓝图延迟动作 */
+/** Blueprint latent action waiting for an asynchronous spawn request to complete */
+class FFireflyActorPoolSpawnLatentAction : public FPendingLatentAction
+{
+public:
+	struct FState
+	{
+		bool bCompleted = false;
+
+		TWeakObjectPtr<AActor> SpawnedActor;
+	};
+
+	FFireflyActorPoolSpawnLatentAction(const FLatentActionInfo& LatentInfo, AActor*& InSpawnedActor)
+		: ExecutionFunction(LatentInfo.ExecutionFunction)
+		, OutputLink(LatentInfo.Linkage)
+		, CallbackTarget(LatentInfo.CallbackTarget)
+		, SpawnedActor(InSpawnedActor)
+		, State(MakeShared<FState>())
+	{
+	}
+
+	virtual void UpdateOperation(FLatentResponse& Response) override
+	{
+		if (State->bCompleted)
+		{
+			SpawnedActor = State->SpawnedActor.Get();
+		}
+		Response.FinishAndTriggerIf(State->bCompleted, ExecutionFunction, OutputLink, CallbackTarget);
+	}
+
+	FName ExecutionFunction;
+
+	int32 OutputLink;
+
+	FWeakObjectPtr CallbackTarget;
+
+	AActor*& SpawnedActor;
+
+	// 与生成请求共享的状态，延迟动作先于请求销毁时请求仍可安全写入。
+	// State shared with the spawn request, so the request can still write it safely if the latent action is destroyed first.
+	TSharedRef<FState> State;
+};
+
+int32 UFireflyObjectPoolWorldSubsystem::K2_ActorPool_SpawnActorAsync(const UObject* WorldContextObject,
+	TSubclassOf<AActor> ActorClass, FName ActorID, const FTransform& Transform, FFireflyActorPoolSpawnDelegate OnSpawned,
+	float Lifetime, AActor* Owner, APawn* Instigator)
+{
+	return ActorPool_SpawnActorAsync(WorldContextObject, ActorClass, ActorID, Transform
+		, [OnSpawned](AActor* SpawnedActor) { OnSpawned.ExecuteIfBound(SpawnedActor); }, Lifetime, Owner, Instigator);
+}
+
+int32 UFireflyObjectPoolWorldSubsystem::ActorPool_SpawnActorAsync(const UObject* WorldContextObject,
+	TSubclassOf<AActor> ActorClass, FName ActorID, const FTransform& Transform, TFunction<void(AActor*)> OnSpawned,
+	float Lifetime, AActor* Owner, APawn* Instigator)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UFireflyObjectPoolWorldSubsystem* Subsystem = UWorld::GetSubsystem<UFireflyObjectPoolWorldSubsystem>(World);
+	if (!Subsystem || (!IsValid(ActorClass) && ActorID == NAME_None))
+	{
+		if (OnSpawned)
+		{
+			OnSpawned(nullptr);
+		}
+		return INDEX_NONE;
+	}
+
+	const int32 RequestID = Subsystem->NextSpawnRequestID++;
+
+	// 命中对象池的请求立即完成，只有未命中的请求才排队，且排在已有请求之后以保持顺序。
+	// Requests hitting the pool complete immediately, only misses are queued, behind the existing ones to keep the order.
+	const FFireflyActorPool* Pool = ActorID != NAME_None ? ActorPoolOfID.Find(ActorID) : ActorPoolOfClass.Find(ActorClass);
+	if (Pool && Pool->Actors.Num() > 0 && Subsystem->PendingSpawnRequests.Num() == 0)
+	{
+		AActor* Actor = Subsystem->SpawnActor_Internal(ActorClass, ActorID, Transform, Lifetime, Owner, Instigator);
+		if (OnSpawned)
+		{
+			OnSpawned(Actor);
+		}
+		return RequestID;
+	}
+
+	FFireflyActorPoolSpawnRequest& Request = Subsystem->PendingSpawnRequests.AddDefaulted_GetRef();
+	Request.RequestID = RequestID;
+	Request.ActorClass = ActorClass;
+	Request.ActorID = ActorID;
+	Request.Transform = Transform;
+	Request.Lifetime = Lifetime;
+	Request.Owner = Owner;
+	Request.Instigator = Instigator;
+	Request.OnSpawned = MoveTemp(OnSpawned);
+
+	return RequestID;
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_SpawnActorLatent(const UObject* WorldContextObject,
+	FLatentActionInfo LatentInfo, TSubclassOf<AActor> ActorClass, FName ActorID, const FTransform& Transform,
+	float Lifetime, AActor* Owner, APawn* Instigator, AActor*& SpawnedActor)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (!IsValid(World))
+	{
+		return;
+	}
+
+	FLatentActionManager& LatentActionManager = World->GetLatentActionManager();
+	if (LatentActionManager.FindExistingAction<FFireflyActorPoolSpawnLatentAction>(LatentInfo.CallbackTarget, LatentInfo.UUID))
+	{
+		return;
+	}
+
+	FFireflyActorPoolSpawnLatentAction* Action = new FFireflyActorPoolSpawnLatentAction(LatentInfo, SpawnedActor);
+	LatentActionManager.AddNewAction(LatentInfo.CallbackTarget, LatentInfo.UUID, Action);
+
+	TSharedRef<FFireflyActorPoolSpawnLatentAction::FState> State = Action->State;
+	ActorPool_SpawnActorAsync(WorldContextObject, ActorClass, ActorID, Transform, [State](AActor* Actor)
+	{
+		State->SpawnedActor = Actor;
+		State->bCompleted = true;
+	}, Lifetime, Owner, Instigator);
+}
+
+bool UFireflyObjectPoolWorldSubsystem::ActorPool_CancelSpawnRequest(const UObject* WorldContextObject, int32 RequestID)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UFireflyObjectPoolWorldSubsystem* Subsystem = UWorld::GetSubsystem<UFireflyObjectPoolWorldSubsystem>(World);
+	if (!Subsystem)
+	{
+		return false;
+	}
+
+	const int32 Index = Subsystem->PendingSpawnRequests.IndexOfByPredicate(
+		[RequestID](const FFireflyActorPoolSpawnRequest& Request) { return Request.RequestID == RequestID; });
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	TFunction<void(AActor*)> OnSpawned = MoveTemp(Subsystem->PendingSpawnRequests[Index].OnSpawned);
+	Subsystem->PendingSpawnRequests.RemoveAt(Index);
+	if (OnSpawned)
+	{
+		OnSpawned(nullptr);
+	}
+
+	return true;
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_CancelAllSpawnRequests(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UFireflyObjectPoolWorldSubsystem* Subsystem = UWorld::GetSubsystem<UFireflyObjectPoolWorldSubsystem>(World);
+	if (!Subsystem)
+	{
+		return;
+	}
+
+	TArray<FFireflyActorPoolSpawnRequest> CancelledRequests = MoveTemp(Subsystem->PendingSpawnRequests);
+	Subsystem->PendingSpawnRequests.Reset();
+	for (FFireflyActorPoolSpawnRequest& Request : CancelledRequests)
+	{
+		if (Request.OnSpawned)
+		{
+			Request.OnSpawned(nullptr);
+		}
+	}
+}
+
+int32 UFireflyObjectPoolWorldSubsystem::ActorPool_GetPendingSpawnRequestNum(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const UFireflyObjectPoolWorldSubsystem* Subsystem = UWorld::GetSubsystem<UFireflyObjectPoolWorldSubsystem>(World);
+
+	return Subsystem ? Subsystem->PendingSpawnRequests.Num() : 0;
+}
+
+void UFireflyObjectPoolWorldSubsystem::ProcessSpawnRequests()
+{
+	if (PendingSpawnRequests.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 MaxPerFrame = CVarFireflyObjectPoolSpawnQueueMaxPerFrame.GetValueOnGameThread();
+	const double EndTime = FPlatformTime::Seconds() + CVarFireflyObjectPoolSpawnQueueBudgetMs.GetValueOnGameThread() / 1000.0;
+
+	// 每次从队首取出一个请求后再生成和回调，回调中取消或发起的请求不会影响正在处理的请求。
+	// Pop one request off the front before spawning and calling back, so requests cancelled or issued from callbacks don't affect the one being processed.
+	int32 NumInstantiated = 0;
+	while (PendingSpawnRequests.Num() > 0 && FPlatformTime::Seconds() < EndTime)
+	{
+		const FFireflyActorPoolSpawnRequest& Next = PendingSpawnRequests[0];
+		const FFireflyActorPool* Pool = Next.ActorID != NAME_None ? ActorPoolOfID.Find(Next.ActorID) : ActorPoolOfClass.Find(Next.ActorClass);
+		const bool bHit = Pool && Pool->Actors.Num() > 0;
+		if (!bHit && MaxPerFrame > 0 && NumInstantiated >= MaxPerFrame)
+		{
+			break;
+		}
+
+		FFireflyActorPoolSpawnRequest Request = MoveTemp(PendingSpawnRequests[0]);
+		PendingSpawnRequests.RemoveAt(0, 1, false);
+
+		AActor* Actor = SpawnActor_Internal(Request.ActorClass, Request.ActorID, Request.Transform, Request.Lifetime
+			, Request.Owner.Get(), Request.Instigator.Get());
+		if (!bHit)
+		{
+			++NumInstantiated;
+		}
+
+		if (Request.OnSpawned)
+		{
+			Request.OnSpawned(Actor);
+		}
+	}
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::SpawnNewActor_Internal(UWorld* World, TSubclassOf<AActor> ActorClass,
+	FName ActorID, const FTransform& Transform, FActorSpawnParameters& SpawnParameters)
+{
+	FFireflyActorPool* Pool = ActorID != NAME_None ? ActorPoolOfID.Find(ActorID) : ActorPoolOfClass.Find(ActorClass);
+
+	// 延迟构造的生成需要由调用者执行构造脚本，只能从类默认对象生成。
+	// Deferred spawns have their construction run by the caller, so they can only spawn from the class defaults.
+	AActor* Template = Pool && Pool->Config.bSpawnFromTemplate && !SpawnParameters.bDeferConstruction
+		? GetOrCreateTemplateActor(World, *Pool, ActorClass, ActorID) : nullptr;
+	AActor* Actor = IsValid(Template)
+		? DuplicateTemplateActor(World, Template, Transform, SpawnParameters)
+		: World->SpawnActor<AActor>(ActorClass, Transform, SpawnParameters);
+	if (IsValid(Actor) && !SpawnParameters.bDeferConstruction)
+	{
+		// 先剥离表现组件，使采样的内存只包含玩法部分。
+		// Strip the cosmetic components first, so the sampled memory only covers the gameplay parts.
+		if (Pool && Pool->Config.bStripCosmeticsOnServer)
+		{
+			UFireflyObjectPoolLibrary::StripCosmeticComponents(World, Actor);
+		}
+		if (Pool && Pool->Config.bResetPropertiesOnRelease)
+		{
+			FFireflyPropertyResetCache::CaptureBaseline(World, ActorClass);
+		}
+	}
+
+	return Actor;
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::SpawnNewActor_Internal(UWorld* World, TSubclassOf<AActor> ActorClass,
+	FName ActorID, const FTransform& Transform, AActor* Owner, APawn* Instigator,
+	ESpawnActorCollisionHandlingMethod CollisionHandling)
+{
+	if (!IsValid(World))
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Owner = Owner;
+	SpawnParameters.Instigator = Instigator;
+	SpawnParameters.SpawnCollisionHandlingOverride = CollisionHandling;
+
+	return SpawnNewActor_Internal(World, ActorClass, ActorID, Transform, SpawnParameters);
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::GetOrCreateTemplateActor(UWorld* World, FFireflyActorPool& Pool,
+	TSubclassOf<AActor> ActorClass, FName ActorID)
+{
+	if (IsValid(Pool.TemplateActor) && Pool.TemplateActor->GetClass() == ActorClass)
+	{
+		return Pool.TemplateActor;
+	}
+
+	if (IsValid(Pool.TemplateActor))
+	{
+		Pool.TemplateActor->Destroy(true);
+	}
+
+	// 与属性重置的探测实例一样，延迟构造后只执行构造，模板实例不会执行组件初始化和BeginPlay，也就不会生成默认控制器。
+	// Like the probe of the property reset, defer construction and run only the construction, so the template never runs component initialization or BeginPlay and never spawns a default controller.
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.bDeferConstruction = true;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+
+	AActor* Template = World->SpawnActor<AActor>(ActorClass, FTransform::Identity, SpawnParameters);
+	Pool.TemplateActor = Template;
+	if (!IsValid(Template))
+	{
+		return nullptr;
+	}
+
+	Template->ExecuteConstruction(FTransform::Identity, nullptr, nullptr, true);
+	if (ActorID != NAME_None)
+	{
+		Pooling_SetActorID(Template, ActorID);
+	}
+
+	// 注销组件和Tick函数，并把模板实例移出关卡的Actor列表和网络Actor列表，使它不被渲染、不参与碰撞、不Tick，也不会被Actor迭代器找到。模板实例只由对象池引用。
+	// Unregister the components and tick functions and take the template out of the Actor list of the level and the network Actor list, so it isn't rendered, doesn't collide, doesn't tick and isn't found by Actor iterators. The template is only referenced by the pool.
+	Template->UnregisterAllComponents();
+	Template->RegisterAllActorTickFunctions(false, true);
+	World->RemoveNetworkActor(Template);
+	if (ULevel* Level = Template->GetLevel())
+	{
+		Level->Actors.RemoveSingle(Template);
+	}
+
+	return Template;
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::DuplicateTemplateActor(UWorld* World, AActor* Template,
+	const FTransform& Transform, const FActorSpawnParameters& SpawnParameters)
+{
+	ULevel* Level = SpawnParameters.OverrideLevel ? SpawnParameters.OverrideLevel : World->PersistentLevel.Get();
+
+	FObjectDuplicationParameters Parameters = InitStaticDuplicateObjectParams(Template, Level);
+	Parameters.FlagMask = RF_AllFlags & ~(RF_Transient | RF_Standalone | RF_Public);
+	Parameters.ApplyFlags = SpawnParameters.ObjectFlags;
+	AActor* Actor = Cast<AActor>(StaticDuplicateObjectEx(Parameters));
+	if (!Actor)
+	{
+		return nullptr;
+	}
+
+	// 复制得到的组件已经包含构造脚本的结果，这里只执行SpawnActor中构造之后的流程，不再执行构造脚本。
+	// The duplicated components already hold the output of the construction script, only the post-construction steps of SpawnActor run here, never the construction script.
+	Level->Actors.Add(Actor);
+	World->AddNetworkActor(Actor);
+
+	// 复制会带上模板实例的所有属性，清除指向其他Actor的控制器和所有者引用，使副本像新生成的Actor一样生成自己的默认控制器。
+	// Duplication carries over every property of the template, clear the controller and owner references to other Actors so the copy spawns its own default controller like a freshly spawned Actor.
+	if (APawn* Pawn = Cast<APawn>(Actor))
+	{
+		Pawn->Controller = nullptr;
+	}
+	Actor->SetOwner(SpawnParameters.Owner);
+	Actor->SetInstigator(SpawnParameters.Instigator);
+	Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Actor->RegisterAllComponents();
+	Actor->PostActorCreated();
+
+	Actor->PreInitializeComponents();
+	Actor->InitializeComponents();
+	Actor->PostInitializeComponents();
+	Actor->UpdateOverlaps();
+	if (World->HasBegunPlay())
+	{
+		Actor->DispatchBeginPlay();
+	}
+
+	return Actor;
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_BenchmarkSpawn(const TArray<FString>& Args, UWorld* World,
+	FOutputDevice& Ar)
+{
+	UClass* ActorClass = Args.Num() > 0 ? FSoftClassPath(Args[0]).TryLoadClass<AActor>() : nullptr;
+	const int32 Count = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100;
+	if (!IsValid(World) || !IsValid(ActorClass))
+	{
+		Ar.Logf(TEXT("Usage: Firefly.ObjectPool.BenchmarkSpawn <ActorClassPath> [Count]"));
+		return;
+	}
+
+	FFireflyActorPool BenchmarkPool;
+	AActor* TemplateActor = GetOrCreateTemplateActor(World, BenchmarkPool, ActorClass, NAME_None);
+
+	auto RunBenchmark = [World, ActorClass, Count](AActor* Template) -> double
+	{
+		TArray<AActor*> SpawnedActors;
+		SpawnedActors.Reserve(Count);
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Count; ++i)
+		{
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			SpawnedActors.Add(Template
+				? DuplicateTemplateActor(World, Template, FTransform::Identity, SpawnParameters)
+				: World->SpawnActor<AActor>(ActorClass, FTransform::Identity, SpawnParameters));
+		}
+		const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+
+		for (AActor* Actor : SpawnedActors)
+		{
+			if (IsValid(Actor))
+			{
+				Actor->Destroy(true);
+			}
+		}
+
+		return ElapsedTime * 1000.0 / Count;
+	};
+
+	const double DefaultsCost = RunBenchmark(nullptr);
+	const double TemplateCost = RunBenchmark(TemplateActor);
+	if (IsValid(TemplateActor))
+	{
+		TemplateActor->Destroy(true);
+	}
+
+	Ar.Logf(TEXT("FireflyObjectPool spawn benchmark of %s, %d spawns each:"), *GetNameSafe(ActorClass), Count);
+	Ar.Logf(TEXT("  From class defaults:     %.4f ms per spawn"), DefaultsCost);
+	Ar.Logf(TEXT("  From template instance:  %.4f ms per spawn"), TemplateCost);
+	Ar.Logf(TEXT("  Savings:                 %.4f ms per spawn (%.1f%%)"), DefaultsCost - TemplateCost
+		, DefaultsCost > 0.0 ? (DefaultsCost - TemplateCost) * 100.0 / DefaultsCost : 0.0);
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_BenchmarkGC(const TArray<FString>& Args, UWorld* World,
+	FOutputDevice& Ar)
+{
+	const int32 Iterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 5;
+
+	int32 NumDormantActors = 0;
+	for (auto& Pool : ActorPoolOfClass)
+	{
+		DissolvePoolCluster(Pool.Value);
+		NumDormantActors += Pool.Value.Actors.Num();
+	}
+	for (auto& Pool : ActorPoolOfID)
+	{
+		DissolvePoolCluster(Pool.Value);
+		NumDormantActors += Pool.Value.Actors.Num();
+	}
+
+	auto RunBenchmark = [Iterations]() -> double
+	{
+		// 先回收一次，使后续的每次回收都只测量可达性分析而不包含清理上次遗留的垃圾。
+		// Collect once first, so each measured collection only covers reachability analysis and not leftovers from before.
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		}
+
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0 / Iterations;
+	};
+
+	const double UnclusteredCost = RunBenchmark();
+
+	int32 NumClusteredObjects = 0;
+	for (auto& Pool : ActorPoolOfClass)
+	{
+		NumClusteredObjects += ClusterPool(Pool.Value);
+	}
+	for (auto& Pool : ActorPoolOfID)
+	{
+		NumClusteredObjects += ClusterPool(Pool.Value);
+	}
+
+	const double ClusteredCost = RunBenchmark();
+
+	// 恢复到由配置决定的状态。
+	// Restore the state decided by the configurations.
+	for (auto& Pool : ActorPoolOfClass)
+	{
+		if (!Pool.Value.Config.bClusterDormantActors)
+		{
+			DissolvePoolCluster(Pool.Value);
+		}
+	}
+	for (auto& Pool : ActorPoolOfID)
+	{
+		if (!Pool.Value.Config.bClusterDormantActors)
+		{
+			DissolvePoolCluster(Pool.Value);
+		}
+	}
+
+	Ar.Logf(TEXT("FireflyObjectPool GC benchmark, %d dormant actors, %d objects clustered, %d collections each:"), NumDormantActors, NumClusteredObjects, Iterations);
+	Ar.Logf(TEXT("  Unclustered:  %.3f ms per collection"), UnclusteredCost);
+	Ar.Logf(TEXT("  Clustered:    %.3f ms per collection"), ClusteredCost);
+	Ar.Logf(TEXT("  Savings:      %.3f ms per collection (%.1f%%)"), UnclusteredCost - ClusteredCost
+		, UnclusteredCost > 0.0 ? (UnclusteredCost - ClusteredCost) * 100.0 / UnclusteredCost : 0.0);
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_BenchmarkCharacterWave(const TArray<FString>& Args, UWorld* World,
+	FOutputDevice& Ar)
+{
+	UClass* CharacterClass = Args.Num() > 0 ? FSoftClassPath(Args[0]).TryLoadClass<ACharacter>() : nullptr;
+	const int32 Count = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 50;
+	const int32 Waves = Args.Num() > 2 ? FMath::Max(FCString::Atoi(*Args[2]), 1) : 5;
+	if (!IsValid(World) || !IsValid(CharacterClass))
+	{
+		Ar.Logf(TEXT("Usage: Firefly.ObjectPool.BenchmarkCharacterWave <CharacterClassPath> [Count] [Waves]"));
+		return;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	// 每个角色错开放置，避免生成时的穿透处理影响结果。
+	// Place every character apart, so spawn overlap resolution doesn't skew the result.
+	auto GetWaveTransform = [](int32 Index)
+	{
+		return FTransform(FVector(200.f * (Index % 32), 200.f * (Index / 32), 0.f));
+	};
+
+	TArray<ACharacter*> Characters;
+	Characters.Reserve(Count);
+
+	double SpawnTime = 0.0;
+	for (int32 Wave = 0; Wave < Waves; ++Wave)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Characters.Add(World->SpawnActor<ACharacter>(CharacterClass, GetWaveTransform(i), SpawnParameters));
+		}
+		SpawnTime += FPlatformTime::Seconds() - StartTime;
+
+		for (ACharacter* Character : Characters)
+		{
+			if (!IsValid(Character))
+			{
+				continue;
+			}
+
+			if (AController* Controller = Character->GetController())
+			{
+				Controller->Destroy();
+			}
+			Character->Destroy(true);
+		}
+		Characters.Reset();
+	}
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		ACharacter* Character = World->SpawnActor<ACharacter>(CharacterClass, GetWaveTransform(i), SpawnParameters);
+		if (IsValid(Character))
+		{
+			UFireflyObjectPoolLibrary::UniversalWarmUp_Character(World, Character);
+			Characters.Add(Character);
+		}
+	}
+
+	double ReactivateTime = 0.0;
+	double ReleaseTime = 0.0;
+	double AnimResetTime = 0.0;
+	double AnimReinitializeTime = 0.0;
+	for (int32 Wave = 0; Wave < Waves; ++Wave)
+	{
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Characters.Num(); ++i)
+		{
+			Characters[i]->SetActorTransform(GetWaveTransform(i), false, nullptr, ETeleportType::ResetPhysics);
+			UFireflyObjectPoolLibrary::UniversalBeginPlay_Character(World, Characters[i]);
+		}
+		ReactivateTime += FPlatformTime::Seconds() - StartTime;
+
+		// 单独对比重置保留的动画实例与之前重新初始化动画实例的耗时。
+		// Compare resetting the preserved anim instance on its own against the previous path reinitializing the anim instance.
+		StartTime = FPlatformTime::Seconds();
+		for (ACharacter* Character : Characters)
+		{
+			if (USkeletalMeshComponent* Mesh = Character->GetMesh())
+			{
+				UFireflyObjectPoolLibrary::ResetAnimInstance(Mesh->GetAnimInstance());
+			}
+		}
+		AnimResetTime += FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (ACharacter* Character : Characters)
+		{
+			if (USkeletalMeshComponent* Mesh = Character->GetMesh())
+			{
+				Mesh->InitAnim(true);
+			}
+		}
+		AnimReinitializeTime += FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (ACharacter* Character : Characters)
+		{
+			UFireflyObjectPoolLibrary::UniversalEndPlay_Character(World, Character);
+		}
+		ReleaseTime += FPlatformTime::Seconds() - StartTime;
+	}
+
+	for (ACharacter* Character : Characters)
+	{
+		if (AController* Controller = Character->GetController())
+		{
+			Controller->Destroy();
+		}
+		Character->Destroy(true);
+	}
+
+	const int32 NumPooled = FMath::Max(Characters.Num(), 1);
+	const double SpawnCost = SpawnTime * 1000.0 / (Count * Waves);
+	const double ReactivateCost = ReactivateTime * 1000.0 / (NumPooled * Waves);
+	const double ReleaseCost = ReleaseTime * 1000.0 / (NumPooled * Waves);
+	const double AnimResetCost = AnimResetTime * 1000.0 / (NumPooled * Waves);
+	const double AnimReinitializeCost = AnimReinitializeTime * 1000.0 / (NumPooled * Waves);
+
+	Ar.Logf(TEXT("FireflyObjectPool character wave benchmark of %s, %d waves of %d characters:"), *GetNameSafe(CharacterClass), Waves, Count);
+	Ar.Logf(TEXT("  Fresh spawn:          %.4f ms per character"), SpawnCost);
+	Ar.Logf(TEXT("  Pooled reactivation:  %.4f ms per character"), ReactivateCost);
+	Ar.Logf(TEXT("  Pooled release:       %.4f ms per character"), ReleaseCost);
+	Ar.Logf(TEXT("  Savings:              %.4f ms per character (%.1f%%)"), SpawnCost - ReactivateCost
+		, SpawnCost > 0.0 ? (SpawnCost - ReactivateCost) * 100.0 / SpawnCost : 0.0);
+	Ar.Logf(TEXT("  Anim instance reset:  %.4f ms per character"), AnimResetCost);
+	Ar.Logf(TEXT("  Anim reinitialize:    %.4f ms per character"), AnimReinitializeCost);
+}
+
+void UFireflyObjectPoolWorldSubsystem::StartupReferenceCollector()
+{
+	if (!GFireflyObjectPoolReferenceCollector.IsValid())
+	{
+		GFireflyObjectPoolReferenceCollector = MakeUnique<FFireflyObjectPoolReferenceCollector>();
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::ShutdownReferenceCollector()
+{
+	GFireflyObjectPoolReferenceCollector.Reset();
+}
+
+void UFireflyObjectPoolWorldSubsystem::AddPoolReferences(FReferenceCollector& Collector)
+{
+	auto AddReferences = [&Collector](FFireflyActorPool& Pool)
+	{
+		// 已组成GC簇的待命Actor只通过簇根报告，避免逐个遍历。
+		// Clustered Actors on standby are only reported through the cluster root instead of one by one.
+		if (Pool.ClusterRoot)
+		{
+			Collector.AddReferencedObject(Pool.ClusterRoot);
+		}
+		else
+		{
+			Collector.AddReferencedObjects(Pool.Actors);
+		}
+
+		// 正在使用的Actor离开世界时会移除记录，这里报告的都是仍在世界中的Actor。
+		// Actors in use are untracked when they leave the world, so the ones reported here are all still in a world.
+		for (FFireflyActiveActorRecord& Record : Pool.ActiveActors)
+		{
+			Collector.AddReferencedObject(Record.Actor);
+		}
+
+		Collector.AddReferencedObject(Pool.TemplateActor);
+		Collector.AddReferencedObject(Pool.Config.LightweightMesh);
+	};
+
+	for (auto& Pool : ActorPoolOfClass)
+	{
+		AddReferences(Pool.Value);
+	}
+
+	for (auto& Pool : ActorPoolOfID)
+	{
+		AddReferences(Pool.Value);
+	}
+
+	for (auto& Pool : ComponentPoolOfClass)
+	{
+		Collector.AddReferencedObjects(Pool.Value);
+	}
+
+	for (auto& Pool : WidgetPoolOfClass)
+	{
+		Collector.AddReferencedObjects(Pool.Value.Widgets);
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::MarkPoolStockChanged(FFireflyActorPool& Pool)
+{
+	DissolvePoolCluster(Pool);
+	Pool.ClusterCountdown = CVarFireflyObjectPoolClusterDelay.GetValueOnGameThread();
+}
+
+int32 UFireflyObjectPoolWorldSubsystem::ClusterPool(FFireflyActorPool& Pool)
+{
+	DissolvePoolCluster(Pool);
+	if (Pool.Actors.Num() == 0)
+	{
+		return 0;
+	}
+
+	UFireflyActorPoolCluster* Cluster = NewObject<UFireflyActorPoolCluster>(GetTransientPackage());
+	Pool.ClusterRoot = Cluster;
+
+	return Cluster->Build(Pool.Actors);
+}
+
+void UFireflyObjectPoolWorldSubsystem::DissolvePoolCluster(FFireflyActorPool& Pool)
+{
+	if (UFireflyActorPoolCluster* Cluster = Cast<UFireflyActorPoolCluster>(Pool.ClusterRoot))
+	{
+		Cluster->Dissolve();
+	}
+	Pool.ClusterRoot = nullptr;
+}
+
+void UFireflyObjectPoolWorldSubsystem::UpdatePoolClusters(float DeltaTime)
+{
+	auto UpdatePool = [DeltaTime](FFireflyActorPool& Pool)
+	{
+		if (!Pool.Config.bClusterDormantActors || Pool.ClusterRoot || Pool.Actors.Num() == 0)
+		{
+			return;
+		}
+
+		Pool.ClusterCountdown -= DeltaTime;
+		if (Pool.ClusterCountdown <= 0.f)
+		{
+			ClusterPool(Pool);
+		}
+	};
+
+	for (auto& Pool : ActorPoolOfClass)
+	{
+		UpdatePool(Pool.Value);
+	}
+
+	for (auto& Pool : ActorPoolOfID)
+	{
+		UpdatePool(Pool.Value);
+	}
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::BorrowActor_Internal(TSubclassOf<AActor> ActorClass, FName ActorID)
+{
+	FFireflyActorPool* Pool = ActorID != NAME_None ? ActorPoolOfID.Find(ActorID) : nullptr;
+	if (!Pool || !Pool->Config.bBorrowFromSameClass || !IsValid(ActorClass))
+	{
+		return nullptr;
+	}
+
+	// 从富余最多的对象池借用，使各对象池的富余尽量均衡。
+	// Borrow from the pool with the most surplus to keep the surplus of the pools balanced.
+	// 跳过已知Actor类不同的对象池，并从末尾查找该类的待命Actor，不假定末尾的Actor就是该类。
+	// Skip pools known to be of another Actor class, and search the Actor of that class from the end instead of assuming the last one matches.
+	FFireflyActorPool* Lender = nullptr;
+	int32 LentIndex = INDEX_NONE;
+	int32 MaxSurplus = 0;
+	for (auto& Other : ActorPoolOfID)
+	{
+		FFireflyActorPool& OtherPool = Other.Value;
+		const int32 Surplus = OtherPool.Actors.Num() - FMath::Max(OtherPool.Config.LowWatermark, 0);
+		if (&OtherPool == Pool || Surplus <= MaxSurplus
+			|| (OtherPool.ActorClass && OtherPool.ActorClass != ActorClass))
+		{
+			continue;
+		}
+
+		for (int32 i = OtherPool.Actors.Num() - 1; i >= 0; --i)
+		{
+			const AActor* Candidate = OtherPool.Actors[i];
+			if (IsValid(Candidate) && Candidate->GetClass() == ActorClass)
+			{
+				Lender = &OtherPool;
+				LentIndex = i;
+				MaxSurplus = Surplus;
+				break;
+			}
+		}
+	}
+
+	if (!Lender)
+	{
+		return nullptr;
+	}
+
+	MarkPoolStockChanged(*Lender);
+	FName Variant = NAME_None;
+	AActor* Actor = Lender->RemoveActorAt(LentIndex, &Variant);
+	++Lender->NumLent;
+	++Pool->NumBorrowed;
+
+	// 与取出一样立即记录到借用方的对象池，并沿用借出时的变体，使回收时按原变体放回。
+	// Track it in the borrowing pool right away like a fetch, keeping the variant it was lent with so it is put back under that variant on release.
+	TrackActiveActor(*Pool, nullptr, ActorID, Actor, Actor->GetOwner());
+	SetActiveVariant(Actor, Variant);
+
+	return Actor;
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::ActorPool_BeginDeferredActorSpawn(const UObject* WorldContext, TSubclassOf<AActor> ActorClass
+	, FName ActorID, const FTransform& SpawnTransform, AActor* Owner, ESpawnActorCollisionHandlingMethod CollisionHandling
+	, bool bSweep)
+{
+	UWorld* World = WorldContext->GetWorld();
+	if (!IsValid(World) || (!IsValid(ActorClass) && ActorID == NAME_None))
+	{
+		return nullptr;
+	}
+
+	auto SetActorID = [ActorID](AActor* InActor)
+	{
+		if (Pooling_GetActorID(InActor) != ActorID && ActorID != NAME_None)
+		{
+			Pooling_SetActorID(InActor, ActorID);
+		}
+	};
+
+	AActor* Actor = ActorPool_FetchActor<AActor>(ActorClass, ActorID);
+	if (!Actor)
+	{
+		Actor = BorrowActor_Internal(ActorClass, ActorID);
+	}
+
+	if (Actor)
+	{
+		SetActorID(Actor);
+		TeleportFetchedActor(Actor, SpawnTransform, bSweep);
+		Actor->SetOwner(Owner);
+
+		return Actor;
+	}
+
+	if (!IsValid(ActorClass))
+	{
+		return nullptr;
+	}
+
+	UObject* MutableWorldContext = const_cast<UObject*>(WorldContext);
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Owner = Owner;
+	SpawnParameters.Instigator = Cast<APawn>(MutableWorldContext);
+	SpawnParameters.SpawnCollisionHandlingOverride = CollisionHandling;
+	SpawnParameters.bDeferConstruction = true;
+
+	Actor = SpawnNewActor_Internal(World, ActorClass, ActorID, SpawnTransform, SpawnParameters);
+	if (!IsValid(Actor))
+	{
+		return nullptr;
+	}
+	SetActorID(Actor);
+
+	return Actor;
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::ActorPool_FinishSpawningActor(const UObject* WorldContext, AActor* Actor
+	, const FTransform& SpawnTransform, float Lifetime)
+{
+	UWorld* World = WorldContext->GetWorld();
+	if (!IsValid(World) || !IsValid(Actor))
+	{
+		return nullptr;
+	}
+
+	if ((!Actor->IsActorInitialized()))
+	{
+		Actor->FinishSpawning(SpawnTransform);
+
+		const FFireflyActorPool* Pool = FindPoolOfActor(Actor);
+		if (Pool && Pool->Config.bStripCosmeticsOnServer)
+		{
+			UFireflyObjectPoolLibrary::StripCosmeticComponents(World, Actor);
+		}
+		if (Pool && Pool->Config.bResetPropertiesOnRelease)
+		{
+			FFireflyPropertyResetCache::CaptureBaseline(World, Actor->GetClass());
+		}
+	}
+
+	Pooling_BeginPlay(Actor);
+	TrackActiveActor(Actor, Actor->GetOwner());
+	SetActorLifetime_Internal(Actor, Lifetime);
+
+	return Actor;
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_ReleaseActor(AActor* Actor)
+{
+	if (!IsValid(Actor) || IsActorOnStandby(Actor))
+	{
+		return;
+	}
+
+	const FName Variant = DetachReleasedActor_Internal(Actor);
+
+	const FName ActorID = Pooling_GetActorID(Actor);
+	Pooling_EndPlay(Actor);
+
+	ReturnActorToPool_Internal(Actor, ActorID, Variant);
+}
+
+FName UFireflyObjectPoolWorldSubsystem::DetachReleasedActor_Internal(AActor* Actor)
+{
+	if (UFireflyObjectPoolWorldSubsystem* Subsystem = UWorld::GetSubsystem<UFireflyObjectPoolWorldSubsystem>(Actor->GetWorld()))
+	{
+		Subsystem->StopWaitingForFX(Actor);
+	}
+
+	FName Variant = NAME_None;
+	UntrackActiveActor(Actor, &Variant);
+
+	return Variant;
+}
+
+void UFireflyObjectPoolWorldSubsystem::ReturnActorToPool_Internal(AActor* Actor, FName ActorID, FName Variant)
+{
+	FFireflyActorPool& Pool = ActorID != NAME_None ? ActorPoolOfID.FindOrAdd(ActorID) : ActorPoolOfClass.FindOrAdd(Actor->GetClass());
+	SamplePool(Pool, Actor);
+	if (Pool.Actors.Num() >= Pool.GetCapacity())
+	{
+		Actor->Destroy(true);
+
+		return;
+	}
+
+	if (Pool.Config.bResetPropertiesOnRelease)
+	{
+		FFireflyPropertyResetCache::ResetToBaseline(Actor);
+	}
+
+	MarkPoolStockChanged(Pool);
+	Pool.LastUsedFrame = GFrameCounter;
+	Pool.PushActor(Actor, Variant);
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_ReleaseActors(const TArray<AActor*>& Actors, bool bWithinFrameBudget)
+{
+	if (bWithinFrameBudget)
+	{
+		for (AActor* Actor : Actors)
+		{
+			if (IsValid(Actor))
+			{
+				QueueRelease(Actor);
+			}
+		}
+
+		return;
+	}
+
+	struct FReleaseGroup
+	{
+		TArray<AActor*> Actors;
+		TArray<FName> Variants;
+	};
+	TMap<FName, FReleaseGroup> ActorsOfID;
+	TMap<TSubclassOf<AActor>, FReleaseGroup> ActorsOfClass;
+	TSet<const AActor*> ReleasedActors;
+	ReleasedActors.Reserve(Actors.Num());
+
+	// 同一批中的Actor通常属于少数几个类和世界，缓存上一个Actor的查找结果。
+	// Actors of a batch usually share a few classes and worlds, cache the lookups of the previous Actor.
+	const UWorld* CachedWorld = nullptr;
+	UFireflyObjectPoolWorldSubsystem* CachedSubsystem = nullptr;
+	const UClass* CachedClass = nullptr;
+	const FFireflyPoolingNativeHooks* CachedHooks = nullptr;
+	bool bCachedInterface = false;
+
+	for (AActor* Actor : Actors)
+	{
+		bool bAlreadyReleased = false;
+		if (!IsValid(Actor))
+		{
+			continue;
+		}
+
+		ReleasedActors.Add(Actor, &bAlreadyReleased);
+		if (bAlreadyReleased || IsActorOnStandby(Actor))
+		{
+			continue;
+		}
+
+		if (Actor->GetWorld() != CachedWorld)
+		{
+			CachedWorld = Actor->GetWorld();
+			CachedSubsystem = UWorld::GetSubsystem<UFireflyObjectPoolWorldSubsystem>(CachedWorld);
+		}
+		if (CachedSubsystem)
+		{
+			CachedSubsystem->StopWaitingForFX(Actor);
+		}
+		FName Variant = NAME_None;
+		UntrackActiveActor(Actor, &Variant);
+
+		if (Actor->GetClass() != CachedClass)
+		{
+			CachedClass = Actor->GetClass();
+			CachedHooks = FindNativeHooks(CachedClass);
+			bCachedInterface = !CachedHooks && CachedClass->ImplementsInterface(UFireflyPoolingActorInterface::StaticClass());
+		}
+
+		FName ActorID = NAME_None;
+		if (CachedHooks)
+		{
+			ActorID = CachedHooks->GetActorID(Actor);
+			CachedHooks->EndPlay(Actor);
+		}
+		else if (bCachedInterface)
+		{
+			ActorID = IFireflyPoolingActorInterface::Execute_PoolingGetActorID(Actor);
+			IFireflyPoolingActorInterface::Execute_PoolingEndPlay(Actor);
+		}
+
+		FReleaseGroup& Group = ActorID != NAME_None ? ActorsOfID.FindOrAdd(ActorID) : ActorsOfClass.FindOrAdd(Actor->GetClass());
+		Group.Actors.Add(Actor);
+		Group.Variants.Add(Variant);
+	}
+
+	for (auto& Group : ActorsOfID)
+	{
+		ReturnActorsToPool_Internal(ActorPoolOfID.FindOrAdd(Group.Key), Group.Value.Actors, Group.Value.Variants);
+	}
+
+	for (auto& Group : ActorsOfClass)
+	{
+		ReturnActorsToPool_Internal(ActorPoolOfClass.FindOrAdd(Group.Key), Group.Value.Actors, Group.Value.Variants);
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::ReturnActorsToPool_Internal(FFireflyActorPool& Pool, TArray<AActor*>& Actors,
+	const TArray<FName>& Variants)
+{
+	if (Actors.Num() == 0)
+	{
+		return;
+	}
+
+	SamplePool(Pool, Actors[0]);
+
+	const int32 NumToKeep = FMath::Clamp(Pool.GetCapacity() - Pool.Actors.Num(), 0, Actors.Num());
+	for (int32 i = NumToKeep; i < Actors.Num(); ++i)
+	{
+		Actors[i]->Destroy(true);
+	}
+	Actors.SetNum(NumToKeep, false);
+
+	if (NumToKeep == 0)
+	{
+		return;
+	}
+
+	if (Pool.Config.bResetPropertiesOnRelease)
+	{
+		for (AActor* Actor : Actors)
+		{
+			FFireflyPropertyResetCache::ResetToBaseline(Actor);
+		}
+	}
+
+	MarkPoolStockChanged(Pool);
+	Pool.LastUsedFrame = GFrameCounter;
+	if (Pool.Config.bIndexVariants)
+	{
+		for (int32 i = 0; i < Actors.Num(); ++i)
+		{
+			Pool.PushActor(Actors[i], Variants[i]);
+		}
+	}
+	else
+	{
+		Pool.Actors.Append(Actors);
+	}
+}
+
+const FFireflyPoolingNativeHooks* UFireflyObjectPoolWorldSubsystem::FindNativeHooks(const UClass* ActorClass)
+{
+	if (NativeHooksOfClass.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	if (const FFireflyPoolingNativeHooks* const* Resolved = ResolvedNativeHooksOfClass.Find(ActorClass))
+	{
+		return *Resolved;
+	}
+
+	const FFireflyPoolingNativeHooks* Hooks = nullptr;
+	for (const UClass* Class = ActorClass; Class && !Hooks; Class = Class->GetSuperClass())
+	{
+		if (const FFireflyPoolingNativeHooks* const* Registered = NativeHooksOfClass.Find(Class))
+		{
+			Hooks = *Registered;
+		}
+	}
+	ResolvedNativeHooksOfClass.Add(ActorClass, Hooks);
+
+	return Hooks;
+}
+
+void UFireflyObjectPoolWorldSubsystem::Pooling_BeginPlay(AActor* Actor)
+{
+	if (const FFireflyPoolingNativeHooks* Hooks = FindNativeHooks(Actor->GetClass()))
+	{
+		Hooks->BeginPlay(Actor);
+	}
+	else if (Actor->Implements<UFireflyPoolingActorInterface>())
+	{
+		IFireflyPoolingActorInterface::Execute_PoolingBeginPlay(Actor);
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::Pooling_EndPlay(AActor* Actor)
+{
+	if (const FFireflyPoolingNativeHooks* Hooks = FindNativeHooks(Actor->GetClass()))
+	{
+		Hooks->EndPlay(Actor);
+	}
+	else if (Actor->Implements<UFireflyPoolingActorInterface>())
+	{
+		IFireflyPoolingActorInterface::Execute_PoolingEndPlay(Actor);
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::Pooling_WarmUp(AActor* Actor)
+{
+	if (const FFireflyPoolingNativeHooks* Hooks = FindNativeHooks(Actor->GetClass()))
+	{
+		Hooks->WarmUp(Actor);
+	}
+	else if (Actor->Implements<UFireflyPoolingActorInterface>())
+	{
+		IFireflyPoolingActorInterface::Execute_PoolingWarmUp(Actor);
+	}
+}
+
+FName UFireflyObjectPoolWorldSubsystem::Pooling_GetActorID(const AActor* Actor)
+{
+	if (const FFireflyPoolingNativeHooks* Hooks = FindNativeHooks(Actor->GetClass()))
+	{
+		return Hooks->GetActorID(Actor);
+	}
+
+	if (Actor->Implements<UFireflyPoolingActorInterface>())
+	{
+		return IFireflyPoolingActorInterface::Execute_PoolingGetActorID(Actor);
+	}
+
+	return NAME_None;
+}
+
+void UFireflyObjectPoolWorldSubsystem::Pooling_SetActorID(AActor* Actor, FName ActorID)
+{
+	if (const FFireflyPoolingNativeHooks* Hooks = FindNativeHooks(Actor->GetClass()))
+	{
+		Hooks->SetActorID(Actor, ActorID);
+	}
+	else if (Actor->Implements<UFireflyPoolingActorInterface>())
+	{
+		IFireflyPoolingActorInterface::Execute_PoolingSetActorID(Actor, ActorID);
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_WarmUp(const UObject* WorldContextObject,
+	TSubclassOf<AActor> ActorClass, FName ActorID, const FTransform& Transform, AActor* Owner, APawn* Instigator,
+	int32 Count)
+{
+	UWorld* World = WorldContextObject->GetWorld();
+
+	if (!IsValid(World) || !IsValid(ActorClass) || Count <= 0)
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Owner = Owner;
+	SpawnParameters.Instigator = Instigator;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	FFireflyActorPool& Pool = ActorID != NAME_None ? ActorPoolOfID.FindOrAdd(ActorID) : ActorPoolOfClass.FindOrAdd(ActorClass);
+	Pool.Actors.Reserve(Pool.Actors.Num() + Count);
+	for (int32 i = 0; i < Count; i++)
+	{
+		if (Pool.Actors.Num() >= Pool.GetCapacity())
+		{
+			break;
+		}
+
+		WarmUpActor_Internal(World, Pool, ActorClass, ActorID, Transform, SpawnParameters);
+	}
+}
+
+bool UFireflyObjectPoolWorldSubsystem::WarmUpActor_Internal(UWorld* World, FFireflyActorPool& Pool,
+	TSubclassOf<AActor> ActorClass, FName ActorID, const FTransform& Transform, FActorSpawnParameters& SpawnParameters)
+{
+	AActor* Actor = SpawnNewActor_Internal(World, ActorClass, ActorID, Transform, SpawnParameters);
+	if (!IsValid(Actor))
+	{
+		return false;
+	}
+
+	if (ActorID != NAME_None)
+	{
+		Pooling_SetActorID(Actor, ActorID);
+	}
+	Pooling_WarmUp(Actor);
+
+	SamplePool(Pool, Actor);
+	MarkPoolStockChanged(Pool);
+	Pool.PushActor(Actor);
+
+	return true;
+}
+
+void UFireflyObjectPoolWorldSubsystem::RefillPools(float DeltaTime)
+{
+	if (DeltaTime <= 0.f)
+	{
+		return;
+	}
+
+	const float SmoothingTime = FMath::Max(CVarFireflyObjectPoolDemandSmoothingTime.GetValueOnGameThread(), KINDA_SMALL_NUMBER);
+	const float Alpha = 1.f - FMath::Exp(-DeltaTime / SmoothingTime);
+	const float Lookahead = FMath::Max(CVarFireflyObjectPoolDemandLookahead.GetValueOnGameThread(), 0.f);
+
+	// 先更新所有对象池的需求预测并收集需要补充的对象池，生成Actor可能会修改对象池映射，所以不在遍历时生成。
+	// Update the demand prediction of all pools and collect the ones to refill first, spawning Actors may modify the pool maps so nothing is spawned while iterating.
+	auto UpdatePool = [DeltaTime, Alpha, Lookahead](FFireflyActorPool& Pool)
+	{
+		Pool.FetchRate += Alpha * (Pool.PendingFetches / DeltaTime - Pool.FetchRate);
+		Pool.PendingFetches = 0;
+
+		if (Pool.Config.LowWatermark <= 0)
+		{
+			Pool.bRefilling = false;
+			return false;
+		}
+
+		const int32 PredictedDemand = FMath::CeilToInt(Pool.FetchRate * Lookahead);
+		if (Pool.Actors.Num() - PredictedDemand < Pool.Config.LowWatermark)
+		{
+			Pool.bRefilling = true;
+		}
+
+		return Pool.bRefilling;
+	};
+
+	TArray<TSubclassOf<AActor>> ClassesToRefill;
+	TArray<FName> IDsToRefill;
+	for (auto& Pool : ActorPoolOfClass)
+	{
+		if (UpdatePool(Pool.Value))
+		{
+			ClassesToRefill.Add(Pool.Key);
+		}
+	}
+
+	for (auto& Pool : ActorPoolOfID)
+	{
+		if (UpdatePool(Pool.Value))
+		{
+			IDsToRefill.Add(Pool.Key);
+		}
+	}
+
+	if (ClassesToRefill.Num() == 0 && IDsToRefill.Num() == 0)
+	{
+		return;
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + CVarFireflyObjectPoolRefillBudgetMs.GetValueOnGameThread() / 1000.0;
+
+	// 补充不能使待命Actor超出全局内存预算，否则会与淘汰来回抵消。
+	// Refilling must not push the Actors on standby over the global memory budget, otherwise it would fight the eviction.
+	const float BudgetMegabytes = CVarFireflyObjectPoolDormantBudgetMB.GetValueOnGameThread();
+	const int64 BudgetBytes = BudgetMegabytes > 0.f ? static_cast<int64>(BudgetMegabytes * 1024.f * 1024.f) : MAX_int64;
+	int64 TotalBytes = BudgetMegabytes > 0.f ? GetTotalDormantBytes() : 0;
+
+	// 补充一个Actor，返回对象池是否仍需继续补充。
+	// Refill one Actor, return whether the pool still needs refilling.
+	// 补充的Actor生成在对象池所属的世界中，而不是恰好先Tick的世界。
+	// Refilled Actors are spawned into the world the pool belongs to rather than whichever world happens to tick first.
+	auto RefillOne = [this, Lookahead, BudgetBytes, &TotalBytes](FFireflyActorPool& Pool, TSubclassOf<AActor> ActorClass, FName ActorID)
+	{
+		UWorld* World = GetPoolWorld(Pool);
+		if (!World)
+		{
+			World = GetWorld();
+		}
+		if (!World->IsGameWorld() || World->bIsTearingDown)
+		{
+			Pool.bRefilling = false;
+			return false;
+		}
+
+		const int32 PredictedDemand = FMath::CeilToInt(Pool.FetchRate * Lookahead);
+		const int32 TargetCount = FMath::Min(FMath::Max(Pool.Config.HighWatermark, Pool.Config.LowWatermark + PredictedDemand), Pool.GetCapacity());
+		if (Pool.Actors.Num() >= TargetCount || !IsValid(ActorClass) || TotalBytes + FMath::Max<int64>(Pool.SampledActorBytes, 0) > BudgetBytes)
+		{
+			Pool.bRefilling = false;
+			return false;
+		}
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		if (!WarmUpActor_Internal(World, Pool, ActorClass, ActorID, FTransform::Identity, SpawnParameters))
+		{
+			Pool.bRefilling = false;
+			return false;
+		}
+		TotalBytes += Pool.SampledActorBytes;
+
+		return true;
+	};
+
+	for (const TSubclassOf<AActor>& ActorClass : ClassesToRefill)
+	{
+		while (FPlatformTime::Seconds() < EndTime)
+		{
+			FFireflyActorPool* Pool = ActorPoolOfClass.Find(ActorClass);
+			if (!Pool || !RefillOne(*Pool, ActorClass, NAME_None))
+			{
+				break;
+			}
+		}
+	}
+
+	for (const FName& ActorID : IDsToRefill)
+	{
+		while (FPlatformTime::Seconds() < EndTime)
+		{
+			FFireflyActorPool* Pool = ActorPoolOfID.Find(ActorID);
+			if (!Pool || !RefillOne(*Pool, Pool->ActorClass, ActorID))
+			{
+				break;
+			}
+		}
+	}
+}
+
+UWorld* UFireflyObjectPoolWorldSubsystem::GetPoolWorld(const FFireflyActorPool& Pool)
+{
+	for (const AActor* Actor : Pool.Actors)
+	{
+		if (IsValid(Actor))
+		{
+			return Actor->GetWorld();
+		}
+	}
+
+	for (const FFireflyActiveActorRecord& Record : Pool.ActiveActors)
+	{
+		if (IsValid(Record.Actor))
+		{
+			return Record.Actor->GetWorld();
+		}
+	}
+
+	return IsValid(Pool.TemplateActor) ? Pool.TemplateActor->GetWorld() : nullptr;
+}
+
+void UFireflyObjectPoolWorldSubsystem::ComponentPool_WarmUp(const UObject* WorldContextObject,
+	TSubclassOf<UActorComponent> ComponentClass, int32 Count)
+{
+	UWorld* World = WorldContextObject->GetWorld();
+	if (!IsValid(World) || !IsValid(ComponentClass) || Count <= 0)
+	{
+		return;
+	}
+
+	TComponentPoolList& Pool = ComponentPoolOfClass.FindOrAdd(ComponentClass);
+	Pool.Reserve(Pool.Num() + Count);
+	for (int32 i = 0; i < Count; i++)
+	{
+		UActorComponent* Component = NewObject<UActorComponent>(World, ComponentClass, NAME_None, RF_Transient);
+		UFireflyObjectPoolLibrary::UniversalWarmUp_Component(WorldContextObject, Component);
+		Pool.Push(Component);
+	}
+}
+
+UActorComponent* UFireflyObjectPoolWorldSubsystem::K2_ComponentPool_SpawnComponent(const UObject* WorldContextObject,
+	TSubclassOf<UActorComponent> ComponentClass, AActor* Host, USceneComponent* AttachParent, FName SocketName,
+	const FTransform& RelativeTransform)
+{
+	UWorld* World = WorldContextObject->GetWorld();
+	if (!IsValid(World) || !IsValid(ComponentClass) || !IsValid(Host))
+	{
+		return nullptr;
+	}
+
+	UActorComponent* Component = AcquireComponent_Internal(World, ComponentClass, Host);
+	if (!IsValid(AttachParent))
+	{
+		AttachParent = Host->GetRootComponent();
+	}
+	ActivateComponent_Internal(World, Component, AttachParent, SocketName, RelativeTransform);
+
+	return Component;
+}
+
+UActorComponent* UFireflyObjectPoolWorldSubsystem::AcquireComponent_Internal(UWorld* World,
+	TSubclassOf<UActorComponent> ComponentClass, AActor* Host)
+{
+	// 对象池由所有世界共享，只取出属于当前世界的Component，其他世界的Component留在池中。
+	// The pools are shared by all worlds, only Components of the current world are taken out, Components of other worlds stay in the pool.
+	UActorComponent* Component = nullptr;
+	if (TComponentPoolList* Pool = ComponentPoolOfClass.Find(ComponentClass))
+	{
+		for (int32 i = Pool->Num() - 1; i >= 0; --i)
+		{
+			UActorComponent* Candidate = (*Pool)[i];
+			const bool bValid = IsValid(Candidate);
+			if (bValid && Candidate->GetWorld() != World)
+			{
+				continue;
+			}
+
+			Pool->RemoveAt(i, 1, false);
+			if (bValid)
+			{
+				Component = Candidate;
+				break;
+			}
+		}
+	}
+
+	UObject* Outer = IsValid(Host) ? static_cast<UObject*>(Host) : static_cast<UObject*>(World);
+	if (IsValid(Component))
+	{
+		if (Component->GetOuter() != Outer)
+		{
+			Component->Rename(nullptr, Outer, REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional);
+		}
+	}
+	else
+	{
+		Component = NewObject<UActorComponent>(Outer, ComponentClass, NAME_None, RF_Transient);
+	}
+
+	if (IsValid(Host))
+	{
+		Host->AddInstanceComponent(Component);
+	}
+
+	return Component;
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActivateComponent_Internal(UWorld* World, UActorComponent* Component,
+	USceneComponent* AttachParent, FName SocketName, const FTransform& Transform)
+{
+	if (USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
+	{
+		if (IsValid(AttachParent))
+		{
+			SceneComponent->SetupAttachment(AttachParent, SocketName);
+			SceneComponent->SetRelativeTransform(Transform);
+		}
+		else
+		{
+			SceneComponent->SetWorldTransform(Transform);
+		}
+	}
+
+	if (IsValid(Component->GetOwner()))
+	{
+		Component->RegisterComponent();
+	}
+	else
+	{
+		Component->RegisterComponentWithWorld(World);
+	}
+
+	UFireflyObjectPoolLibrary::UniversalBeginPlay_Component(World, Component);
+}
+
+void UFireflyObjectPoolWorldSubsystem::ComponentPool_ReleaseComponent(UActorComponent* Component)
+{
+	if (!IsValid(Component) || Component->IsBeingDestroyed())
+	{
+		return;
+	}
+
+	UWorld* World = Component->GetWorld();
+	if (!IsValid(World))
+	{
+		return;
+	}
+
+	// 已经在池中的Component不重复回收，也不重复调用回收接口。
+	// A Component already in the pool isn't released again, nor is its release interface called again.
+	const TComponentPoolList* ExistingPool = ComponentPoolOfClass.Find(Component->GetClass());
+	if (ExistingPool && ExistingPool->Contains(Component))
+	{
+		return;
+	}
+
+	if (UFXSystemComponent* FXComponent = Cast<UFXSystemComponent>(Component))
+	{
+		if (UFireflyObjectPoolWorldSubsystem* Subsystem = World->GetSubsystem<UFireflyObjectPoolWorldSubsystem>())
+		{
+			Subsystem->UnbindFXFinished(FXComponent);
+		}
+	}
+
+	UFireflyObjectPoolLibrary::UniversalEndPlay_Component(Component, Component);
+
+	if (USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
+	{
+		SceneComponent->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
+	}
+
+	if (Component->IsRegistered())
+	{
+		Component->UnregisterComponent();
+	}
+
+	if (AActor* Host = Component->GetOwner())
+	{
+		Host->RemoveInstanceComponent(Component);
+	}
+
+	if (Component->GetOuter() != World)
+	{
+		Component->Rename(nullptr, World, REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional);
+	}
+
+	TComponentPoolList& Pool = ComponentPoolOfClass.FindOrAdd(Component->GetClass());
+	Pool.Push(Component);
+}
+
+void UFireflyObjectPoolWorldSubsystem::ComponentPool_ClearAll()
+{
+	for (auto& Pool : ComponentPoolOfClass)
+	{
+		for (auto Component : Pool.Value)
+		{
+			if (IsValid(Component))
+			{
+				Component->DestroyComponent();
+			}
+		}
+	}
+
+	ComponentPoolOfClass.Empty();
+}
+
+void UFireflyObjectPoolWorldSubsystem::ComponentPool_ClearByClass(TSubclassOf<UActorComponent> ComponentClass)
+{
+	if (TComponentPoolList* Pool = ComponentPoolOfClass.Find(ComponentClass))
+	{
+		for (auto Component : *Pool)
+		{
+			if (IsValid(Component))
+			{
+				Component->DestroyComponent();
+			}
+		}
+		Pool->Empty();
+		ComponentPoolOfClass.Remove(ComponentClass);
+	}
+}
+
+int32 UFireflyObjectPoolWorldSubsystem::ComponentPool_DebugComponentNumberOfClass(
+	TSubclassOf<UActorComponent> ComponentClass)
+{
+	if (!ComponentPoolOfClass.Contains(ComponentClass))
+	{
+		return -1;
+	}
+
+	return ComponentPoolOfClass[ComponentClass].Num();
+}
+
+void UFireflyObjectPoolWorldSubsystem::WidgetPool_WarmUp(const UObject* WorldContextObject,
+	TSubclassOf<UUserWidget> WidgetClass, APlayerController* OwningPlayer, int32 Count)
+{
+	UWorld* World = WorldContextObject->GetWorld();
+	if (!IsValid(World) || !IsValid(WidgetClass) || Count <= 0)
+	{
+		return;
+	}
+
+	FFireflyWidgetPool& Pool = WidgetPoolOfClass.FindOrAdd(WidgetClass);
+	for (int32 i = 0; i < Count && Pool.Widgets.Num() < Pool.GetCapacity(); i++)
+	{
+		TSharedPtr<SWidget> SlateWidget;
+		UUserWidget* Widget = CreateWidget_Internal(World, WidgetClass, OwningPlayer, SlateWidget);
+		if (!IsValid(Widget))
+		{
+			continue;
+		}
+
+		if (Widget->Implements<UFireflyPoolingWidgetInterface>())
+		{
+			IFireflyPoolingWidgetInterface::Execute_PoolingWarmUp(Widget);
+		}
+
+		Pool.SlateWidgets.Add(SlateWidget);
+		Pool.Widgets.Push(Widget);
+	}
+}
+
+UUserWidget* UFireflyObjectPoolWorldSubsystem::K2_WidgetPool_FetchWidget(const UObject* WorldContextObject,
+	TSubclassOf<UUserWidget> WidgetClass, APlayerController* OwningPlayer)
+{
+	UWorld* World = WorldContextObject->GetWorld();
+	if (!IsValid(World) || !IsValid(WidgetClass))
+	{
+		return nullptr;
+	}
+
+	// 对象池由所有世界共享，只取出属于当前世界的Widget，其他世界的Widget留在池中。
+	// The pools are shared by all worlds, only Widgets of the current world are taken out, Widgets of other worlds stay in the pool.
+	UUserWidget* Widget = nullptr;
+	if (FFireflyWidgetPool* Pool = WidgetPoolOfClass.Find(WidgetClass))
+	{
+		for (int32 i = Pool->Widgets.Num() - 1; i >= 0; --i)
+		{
+			UUserWidget* Candidate = Pool->Widgets[i];
+			const bool bValid = IsValid(Candidate);
+			if (bValid && Candidate->GetWorld() != World)
+			{
+				continue;
+			}
+
+			Pool->Widgets.RemoveAt(i, 1, false);
+			Pool->SlateWidgets.RemoveAt(i, 1, false);
+			if (bValid)
+			{
+				Widget = Candidate;
+				break;
+			}
+		}
+	}
+
+	if (IsValid(Widget))
+	{
+		if (IsValid(OwningPlayer) && Widget->GetOwningPlayer() != OwningPlayer)
+		{
+			Widget->SetOwningPlayer(OwningPlayer);
+		}
+	}
+	else
+	{
+		TSharedPtr<SWidget> SlateWidget;
+		Widget = CreateWidget_Internal(World, WidgetClass, OwningPlayer, SlateWidget);
+		if (!IsValid(Widget))
+		{
+			return nullptr;
+		}
+	}
+
+	// 回收时Widget被折叠，取出时还原为类默认的可见性。
+	// The Widget was collapsed on release, restore the visibility of its class default on fetch.
+	Widget->SetVisibility(GetDefault<UUserWidget>(Widget->GetClass())->GetVisibility());
+	if (Widget->Implements<UFireflyPoolingWidgetInterface>())
+	{
+		IFireflyPoolingWidgetInterface::Execute_PoolingActivate(Widget);
+	}
+
+	return Widget;
+}
+
+void UFireflyObjectPoolWorldSubsystem::WidgetPool_ReleaseWidget(UUserWidget* Widget)
+{
+	if (!IsValid(Widget))
+	{
+		return;
+	}
+
+	// 已经在池中的Widget不重复回收，也不重复调用回收接口。
+	// A Widget already in the pool isn't released again, nor is its release interface called again.
+	const FFireflyWidgetPool* ExistingPool = WidgetPoolOfClass.Find(Widget->GetClass());
+	if (ExistingPool && ExistingPool->Widgets.Contains(Widget))
+	{
+		return;
+	}
+
+	// 先取出Slate控件，移除后控件树仍由对象池持有。
+	// Take the Slate widget first, the widget tree is still held by the pool after removal.
+	TSharedPtr<SWidget> SlateWidget = Widget->GetCachedWidget();
+	Widget->RemoveFromParent();
+	Widget->SetVisibility(ESlateVisibility::Collapsed);
+
+	if (Widget->Implements<UFireflyPoolingWidgetInterface>())
+	{
+		IFireflyPoolingWidgetInterface::Execute_PoolingDeactivate(Widget);
+	}
+
+	FFireflyWidgetPool& Pool = WidgetPoolOfClass.FindOrAdd(Widget->GetClass());
+	if (Pool.Widgets.Num() >= Pool.GetCapacity())
+	{
+		return;
+	}
+
+	Pool.SlateWidgets.Add(SlateWidget);
+	Pool.Widgets.Push(Widget);
+}
+
+void UFireflyObjectPoolWorldSubsystem::WidgetPool_SetMaxCountOfClass(TSubclassOf<UUserWidget> WidgetClass,
+	int32 MaxCount)
+{
+	if (!IsValid(WidgetClass))
+	{
+		return;
+	}
+
+	FFireflyWidgetPool& Pool = WidgetPoolOfClass.FindOrAdd(WidgetClass);
+	Pool.MaxCount = MaxCount;
+	if (Pool.Widgets.Num() > Pool.GetCapacity())
+	{
+		Pool.Widgets.SetNum(Pool.GetCapacity());
+		Pool.SlateWidgets.SetNum(Pool.GetCapacity());
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::WidgetPool_ClearAll()
+{
+	WidgetPoolOfClass.Empty();
+}
+
+void UFireflyObjectPoolWorldSubsystem::WidgetPool_ClearByClass(TSubclassOf<UUserWidget> WidgetClass)
+{
+	WidgetPoolOfClass.Remove(WidgetClass);
+}
+
+int32 UFireflyObjectPoolWorldSubsystem::WidgetPool_DebugWidgetNumberOfClass(TSubclassOf<UUserWidget> WidgetClass)
+{
+	const FFireflyWidgetPool* Pool = WidgetPoolOfClass.Find(WidgetClass);
+
+	return Pool ? Pool->Widgets.Num() : -1;
+}
+
+UUserWidget* UFireflyObjectPoolWorldSubsystem::CreateWidget_Internal(UWorld* World,
+	TSubclassOf<UUserWidget> WidgetClass, APlayerController* OwningPlayer, TSharedPtr<SWidget>& OutSlateWidget)
+{
+	UUserWidget* Widget = IsValid(OwningPlayer)
+		? CreateWidget<UUserWidget>(OwningPlayer, WidgetClass)
+		: CreateWidget<UUserWidget>(World, WidgetClass);
+	if (IsValid(Widget))
+	{
+		OutSlateWidget = Widget->TakeWidget();
+	}
+
+	return Widget;
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::ActorPool_SpawnFXActor(const UObject* WorldContextObject,
+	TSubclassOf<AActor> ActorClass, FName ActorID, const FTransform& Transform, AActor* Owner, APawn* Instigator,
+	float Lifetime)
+{
+	UWorld* World = WorldContextObject->GetWorld();
+	UFireflyObjectPoolWorldSubsystem* Subsystem = IsValid(World) ? World->GetSubsystem<UFireflyObjectPoolWorldSubsystem>() : nullptr;
+	if (!Subsystem)
+	{
+		return nullptr;
+	}
+
+	AActor* Actor = Subsystem->SpawnActor_Internal(ActorClass, ActorID, Transform, -1.f, Owner, Instigator);
+	if (!IsValid(Actor))
+	{
+		return nullptr;
+	}
+
+	// 只统计Actor自己的特效组件，附加在它上面的池化特效组件由Component池自己回收。
+	// Only count the FX components of the Actor itself, pooled FX components attached to it are released by the Component pool.
+	TInlineComponentArray<UFXSystemComponent*> FXComponents;
+	Actor->GetComponents(FXComponents);
+	FXComponents.RemoveAll([Subsystem](const UFXSystemComponent* FXComponent)
+	{
+		return !FXComponent->IsActive() || Subsystem->FXComponentTargets.Contains(FXComponent);
+	});
+
+	// 循环特效永远不会播放完毕，此时回退到调用者提供的生命周期。
+	// Looping effects never finish, fall back to the lifetime given by the caller then.
+	if (FXComponents.ContainsByPredicate([](const UFXSystemComponent* FXComponent) { return IsLoopingFX(FXComponent); }))
+	{
+		SetActorLifetime_Internal(Actor, Lifetime);
+
+		return Actor;
+	}
+
+	for (UFXSystemComponent* FXComponent : FXComponents)
+	{
+		Subsystem->BindFXFinished(FXComponent, Actor);
+	}
+
+	if (FXComponents.Num() > 0)
+	{
+		Subsystem->PendingFXActors.Add(Actor, FXComponents.Num());
+	}
+
+	return Actor;
+}
+
+UFXSystemComponent* UFireflyObjectPoolWorldSubsystem::FXPool_SpawnSystemAtLocation(const UObject* WorldContextObject,
+	UFXSystemAsset* SystemTemplate, FVector Location, FRotator Rotation, FVector Scale)
+{
+	return SpawnSystem_Internal(WorldContextObject, SystemTemplate, nullptr, NAME_None, FTransform(Rotation, Location, Scale));
+}
+
+UFXSystemComponent* UFireflyObjectPoolWorldSubsystem::FXPool_SpawnSystemAttached(const UObject* WorldContextObject,
+	UFXSystemAsset* SystemTemplate, USceneComponent* AttachToComponent, FName SocketName, FVector Location,
+	FRotator Rotation)
+{
+	if (!IsValid(AttachToComponent))
+	{
+		return nullptr;
+	}
+
+	return SpawnSystem_Internal(WorldContextObject, SystemTemplate, AttachToComponent, SocketName, FTransform(Rotation, Location));
+}
+
+UFXSystemComponent* UFireflyObjectPoolWorldSubsystem::SpawnSystem_Internal(const UObject* WorldContextObject,
+	UFXSystemAsset* SystemTemplate, USceneComponent* AttachToComponent, FName SocketName, const FTransform& Transform)
+{
+	UWorld* World = WorldContextObject->GetWorld();
+	UFireflyObjectPoolWorldSubsystem* Subsystem = IsValid(World) ? World->GetSubsystem<UFireflyObjectPoolWorldSubsystem>() : nullptr;
+	if (!Subsystem || !IsValid(SystemTemplate))
+	{
+		return nullptr;
+	}
+
+	// 循环特效永远不会播放完毕，组件无法自动回收，所以不从Component池播放。
+	// Looping effects never finish and their components could never be released automatically, so they aren't played from the Component pool.
+	UNiagaraSystem* NiagaraSystem = Cast<UNiagaraSystem>(SystemTemplate);
+	UParticleSystem* ParticleSystem = Cast<UParticleSystem>(SystemTemplate);
+	if ((!NiagaraSystem && !ParticleSystem) || (NiagaraSystem && NiagaraSystem->IsLooping())
+		|| (ParticleSystem && ParticleSystem->IsLooping()))
+	{
+		return nullptr;
+	}
+
+	const TSubclassOf<UActorComponent> ComponentClass = NiagaraSystem
+		? UNiagaraComponent::StaticClass() : UParticleSystemComponent::StaticClass();
+	AActor* Host = IsValid(AttachToComponent) ? AttachToComponent->GetOwner() : nullptr;
+	UFXSystemComponent* FXComponent = CastChecked<UFXSystemComponent>(AcquireComponent_Internal(World, ComponentClass, Host));
+
+	FXComponent->bAutoActivate = false;
+	if (UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(FXComponent))
+	{
+		Niagara->SetAutoDestroy(false);
+		Niagara->SetAsset(NiagaraSystem);
+	}
+	else if (UParticleSystemComponent* Particle = Cast<UParticleSystemComponent>(FXComponent))
+	{
+		Particle->bAutoDestroy = false;
+		Particle->SetTemplate(ParticleSystem);
+	}
+
+	ActivateComponent_Internal(World, FXComponent, AttachToComponent, SocketName, Transform);
+	Subsystem->BindFXFinished(FXComponent, nullptr);
+
+	return FXComponent;
+}
+
+bool UFireflyObjectPoolWorldSubsystem::IsLoopingFX(const UFXSystemComponent* FXComponent)
+{
+	if (const UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(FXComponent))
+	{
+		return Niagara->GetAsset() && Niagara->GetAsset()->IsLooping();
+	}
+	if (const UParticleSystemComponent* Particle = Cast<UParticleSystemComponent>(FXComponent))
+	{
+		return Particle->Template && Particle->Template->IsLooping();
+	}
+
+	return false;
+}
+
+void UFireflyObjectPoolWorldSubsystem::BindFXFinished(UFXSystemComponent* FXComponent, AActor* TargetActor)
+{
+	FXComponentTargets.Add(FXComponent, TargetActor);
+	if (UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(FXComponent))
+	{
+		Niagara->OnSystemFinished.AddUniqueDynamic(this, &UFireflyObjectPoolWorldSubsystem::OnNiagaraSystemFinished);
+	}
+	else if (UParticleSystemComponent* Particle = Cast<UParticleSystemComponent>(FXComponent))
+	{
+		Particle->OnSystemFinished.AddUniqueDynamic(this, &UFireflyObjectPoolWorldSubsystem::OnParticleSystemFinished);
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::UnbindFXFinished(UFXSystemComponent* FXComponent)
+{
+	FXComponentTargets.Remove(FXComponent);
+	if (UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(FXComponent))
+	{
+		Niagara->OnSystemFinished.RemoveDynamic(this, &UFireflyObjectPoolWorldSubsystem::OnNiagaraSystemFinished);
+	}
+	else if (UParticleSystemComponent* Particle = Cast<UParticleSystemComponent>(FXComponent))
+	{
+		Particle->OnSystemFinished.RemoveDynamic(this, &UFireflyObjectPoolWorldSubsystem::OnParticleSystemFinished);
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::StopWaitingForFX(AActor* Actor)
+{
+	if (PendingFXActors.Remove(Actor) == 0)
+	{
+		return;
+	}
+
+	TInlineComponentArray<UFXSystemComponent*> FXComponents;
+	Actor->GetComponents(FXComponents);
+	for (UFXSystemComponent* FXComponent : FXComponents)
+	{
+		const TWeakObjectPtr<AActor>* Target = FXComponentTargets.Find(FXComponent);
+		if (Target && Target->Get() == Actor)
+		{
+			UnbindFXFinished(FXComponent);
+		}
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::OnNiagaraSystemFinished(UNiagaraComponent* PSystem)
+{
+	OnFXSystemFinished(PSystem);
+}
+
+void UFireflyObjectPoolWorldSubsystem::OnParticleSystemFinished(UParticleSystemComponent* PSystem)
+{
+	OnFXSystemFinished(PSystem);
+}
+
+void UFireflyObjectPoolWorldSubsystem::OnFXSystemFinished(UFXSystemComponent* FXComponent)
+{
+	if (!IsValid(FXComponent))
+	{
+		return;
+	}
+
+	// 按组件注册时记录的目标处理，池化特效组件可能附加在一个同样在等待特效的特效Actor上。
+	// Resolve by the target recorded when the component was registered, a pooled FX component may be attached to an FX Actor that is waiting too.
+	TWeakObjectPtr<AActor> Target;
+	if (!FXComponentTargets.RemoveAndCopyValue(FXComponent, Target))
+	{
+		return;
+	}
+	UnbindFXFinished(FXComponent);
+
+	if (Target.IsExplicitlyNull())
+	{
+		ComponentPool_ReleaseComponent(FXComponent);
+
+		return;
+	}
+
+	AActor* TargetActor = Target.Get();
+	if (int32* PendingCount = TargetActor ? PendingFXActors.Find(TargetActor) : nullptr)
+	{
+		if (--(*PendingCount) <= 0)
+		{
+			ActorPool_ReleaseActor(TargetActor);
+		}
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_RecallAll(bool bWithinFrameBudget)
+{
+	RecallActors_Internal([](const AActor*) { return true; }, bWithinFrameBudget);
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_RecallByClass(TSubclassOf<AActor> ActorClass, bool bWithinFrameBudget)
+{
+	RecallPool_Internal(ActorPoolOfClass.Find(ActorClass), bWithinFrameBudget);
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_RecallByID(FName ActorID, bool bWithinFrameBudget)
+{
+	RecallPool_Internal(ActorPoolOfID.Find(ActorID), bWithinFrameBudget);
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_RecallByOwner(AActor* Owner, bool bWithinFrameBudget)
+{
+	if (!IsValid(Owner))
+	{
+		return;
+	}
+
+	RecallActors_Internal([Owner](const AActor* Actor) { return Actor->GetOwner() == Owner; }, bWithinFrameBudget);
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_RecallByInstigator(APawn* Instigator, bool bWithinFrameBudget)
+{
+	if (!IsValid(Instigator))
+	{
+		return;
+	}
+
+	RecallActors_Internal([Instigator](const AActor* Actor) { return Actor->GetInstigator() == Instigator; }, bWithinFrameBudget);
+}
+
+TArray<AActor*> UFireflyObjectPoolWorldSubsystem::ActorPool_GetActiveActorsOfClass(TSubclassOf<AActor> ActorClass)
+{
+	TArray<AActor*> ActiveActors;
+	if (const FFireflyActorPool* Pool = ActorPoolOfClass.Find(ActorClass))
+	{
+		ActiveActors.Reserve(Pool->ActiveActors.Num());
+		for (const FFireflyActiveActorRecord& Record : Pool->ActiveActors)
+		{
+			if (IsValid(Record.Actor))
+			{
+				ActiveActors.Add(Record.Actor);
+			}
+		}
+	}
+
+	return ActiveActors;
+}
+
+TArray<AActor*> UFireflyObjectPoolWorldSubsystem::ActorPool_GetActiveActorsOfID(FName ActorID)
+{
+	TArray<AActor*> ActiveActors;
+	if (const FFireflyActorPool* Pool = ActorPoolOfID.Find(ActorID))
+	{
+		ActiveActors.Reserve(Pool->ActiveActors.Num());
+		for (const FFireflyActiveActorRecord& Record : Pool->ActiveActors)
+		{
+			if (IsValid(Record.Actor))
+			{
+				ActiveActors.Add(Record.Actor);
+			}
+		}
+	}
+
+	return ActiveActors;
+}
+
+void UFireflyObjectPoolWorldSubsystem::TrackActiveActor(FFireflyActorPool& Pool, TSubclassOf<AActor> PoolClass,
+	FName PoolID, AActor* Actor, const AActor* Owner)
+{
+	FFireflyActiveActorHandle* Handle = ActiveActorHandles.Find(Actor);
+	if (Handle && (Handle->PoolID != PoolID || (PoolID == NAME_None && Handle->PoolClass != PoolClass)))
+	{
+		UntrackActiveActor(Actor);
+		Handle = nullptr;
+	}
+
+	if (!Handle)
+	{
+		Handle = &ActiveActorHandles.Add(Actor);
+		Handle->PoolClass = PoolClass;
+		Handle->PoolID = PoolID;
+		Handle->Index = Pool.ActiveActors.AddDefaulted();
+
+		if (UFireflyObjectPoolWorldSubsystem* Subsystem = UWorld::GetSubsystem<UFireflyObjectPoolWorldSubsystem>(Actor->GetWorld()))
+		{
+			Actor->OnEndPlay.AddUniqueDynamic(Subsystem, &UFireflyObjectPoolWorldSubsystem::OnActiveActorEndPlay);
+		}
+
+		++Pool.PendingFetches;
+		Pool.LastUsedFrame = GFrameCounter;
+		Pool.ActorClass = Actor->GetClass();
+	}
+
+	const FFireflyActorPoolReleaseTriggers& Triggers = Pool.Config.ReleaseTriggers;
+
+	FFireflyActiveActorRecord& Record = Pool.ActiveActors[Handle->Index];
+	Record.Actor = Actor;
+	Record.SpawnLocation = Actor->GetActorLocation();
+	Record.bHadOwner = IsValid(Owner);
+	if (Triggers.bReleaseOnProjectileStop || Pool.Config.bBatchProjectileMovement)
+	{
+		Record.ProjectileMovement = Actor->FindComponentByClass<UProjectileMovementComponent>();
+	}
+	// 专用服务器没有音频设备，被剥离（注销）的音频组件也不会播放，这些情况下不检测音频播放完毕。
+	// A dedicated server has no audio device and a stripped (unregistered) audio component never plays, the audio trigger is skipped in these cases.
+	Record.Audio = nullptr;
+	Record.bAudioStarted = false;
+	if (Triggers.bReleaseOnAudioFinished && Actor->GetNetMode() != NM_DedicatedServer)
+	{
+		UAudioComponent* Audio = Actor->FindComponentByClass<UAudioComponent>();
+		if (Audio && Audio->IsRegistered())
+		{
+			Record.Audio = Audio;
+		}
+	}
+
+	if (Pool.Config.bBatchProjectileMovement && Record.ProjectileMovement.IsValid())
+	{
+		ApplyBatchedProjectileConfig(Pool, PoolClass, PoolID, Actor->GetWorld());
+		SetProjectileBatched(Pool, Handle->Index, true);
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::TrackActiveActor(AActor* Actor, const AActor* Owner)
+{
+	TrackActiveActor(Actor, Pooling_GetActorID(Actor), Owner);
+}
+
+void UFireflyObjectPoolWorldSubsystem::TrackActiveActor(AActor* Actor, FName ActorID, const AActor* Owner)
+{
+	if (ActorID != NAME_None)
+	{
+		TrackActiveActor(ActorPoolOfID.FindOrAdd(ActorID), nullptr, ActorID, Actor, Owner);
+	}
+	else
+	{
+		TrackActiveActor(ActorPoolOfClass.FindOrAdd(Actor->GetClass()), Actor->GetClass(), NAME_None, Actor, Owner);
+	}
+}
+
+FFireflyActorPool* UFireflyObjectPoolWorldSubsystem::FindPoolOfActor(const AActor* Actor)
+{
+	const FName ActorID = Pooling_GetActorID(Actor);
+	return ActorID != NAME_None ? ActorPoolOfID.Find(ActorID) : ActorPoolOfClass.Find(Actor->GetClass());
+}
+
+bool UFireflyObjectPoolWorldSubsystem::IsActorOnStandby(const AActor* Actor)
+{
+	// 正在使用的Actor不可能在待命，只有不在活跃集合中的Actor才需要查找对象池。
+	// An Actor in use can't be on standby, only Actors outside the active set need to search the pool.
+	if (ActiveActorHandles.Contains(Actor))
+	{
+		return false;
+	}
+
+	const FFireflyActorPool* Pool = FindPoolOfActor(Actor);
+	return Pool && Pool->Actors.Contains(Actor);
+}
+
+void UFireflyObjectPoolWorldSubsystem::UntrackActiveActor(const AActor* Actor, FName* OutVariant)
+{
+	const FFireflyActiveActorHandle* Handle = ActiveActorHandles.Find(Actor);
+	if (!Handle)
+	{
+		return;
+	}
+
+	FFireflyActorPool* Pool = Handle->PoolID != NAME_None ? ActorPoolOfID.Find(Handle->PoolID) : ActorPoolOfClass.Find(Handle->PoolClass);
+	if (Pool && Pool->ActiveActors.IsValidIndex(Handle->Index))
+	{
+		if (OutVariant)
+		{
+			*OutVariant = Pool->ActiveActors[Handle->Index].Variant;
+		}
+		UntrackActiveActorAt(*Pool, Handle->Index);
+	}
+	else
+	{
+		ActiveActorHandles.Remove(Actor);
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::SetActiveVariant(const AActor* Actor, FName Variant)
+{
+	const FFireflyActiveActorHandle* Handle = ActiveActorHandles.Find(Actor);
+	FFireflyActorPool* Pool = Handle
+		? (Handle->PoolID != NAME_None ? ActorPoolOfID.Find(Handle->PoolID) : ActorPoolOfClass.Find(Handle->PoolClass))
+		: nullptr;
+	if (Pool && Pool->ActiveActors.IsValidIndex(Handle->Index))
+	{
+		Pool->ActiveActors[Handle->Index].Variant = Variant;
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::UntrackActiveActorAt(FFireflyActorPool& Pool, int32 Index)
+{
+	AActor* Actor = Pool.ActiveActors[Index].Actor.Get();
+	ActiveActorHandles.Remove(Actor);
+	PendingReleaseSet.Remove(Actor);
+
+	if (IsValid(Actor))
+	{
+		if (UFireflyObjectPoolWorldSubsystem* Subsystem = UWorld::GetSubsystem<UFireflyObjectPoolWorldSubsystem>(Actor->GetWorld()))
+		{
+			Actor->OnEndPlay.RemoveDynamic(Subsystem, &UFireflyObjectPoolWorldSubsystem::OnActiveActorEndPlay);
+		}
+
+		FTimerHandle& LifetimeTimer = Pool.ActiveActors[Index].LifetimeTimer;
+		if (LifetimeTimer.IsValid() && Actor->GetWorld())
+		{
+			Actor->GetWorld()->GetTimerManager().ClearTimer(LifetimeTimer);
+		}
+	}
+
+	if (Pool.BatchedProjectiles.Num() > Index)
+	{
+		SetProjectileBatched(Pool, Index, false);
+		if (Pool.BatchedProjectiles.Num() == Pool.ActiveActors.Num())
+		{
+			Pool.BatchedProjectiles.RemoveAtSwap(Index);
+		}
+		else
+		{
+			Pool.BatchedProjectiles.SetNum(Pool.ActiveActors.Num() - 1);
+		}
+	}
+
+	const int32 LastIndex = Pool.ActiveActors.Num() - 1;
+	if (Index != LastIndex)
+	{
+		if (FFireflyActiveActorHandle* MovedHandle = ActiveActorHandles.Find(Pool.ActiveActors[LastIndex].Actor.Get()))
+		{
+			MovedHandle->Index = Index;
+		}
+	}
+	Pool.ActiveActors.RemoveAtSwap(Index, 1, false);
+}
+
+void UFireflyObjectPoolWorldSubsystem::OnActiveActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	UntrackActiveActor(Actor);
+}
+
+void UFireflyObjectPoolWorldSubsystem::RecallActors_Internal(TFunctionRef<bool(const AActor*)> Predicate,
+	bool bWithinFrameBudget)
+{
+	TArray<AActor*> ActorsToRecall;
+	auto CollectPool = [&Predicate, &ActorsToRecall](const FFireflyActorPool& Pool)
+	{
+		for (const FFireflyActiveActorRecord& Record : Pool.ActiveActors)
+		{
+			if (IsValid(Record.Actor) && Predicate(Record.Actor))
+			{
+				ActorsToRecall.Add(Record.Actor);
+			}
+		}
+	};
+
+	for (const auto& Pool : ActorPoolOfClass)
+	{
+		CollectPool(Pool.Value);
+	}
+
+	for (const auto& Pool : ActorPoolOfID)
+	{
+		CollectPool(Pool.Value);
+	}
+
+	ActorPool_ReleaseActors(ActorsToRecall, bWithinFrameBudget);
+}
+
+void UFireflyObjectPoolWorldSubsystem::RecallPool_Internal(FFireflyActorPool* Pool, bool bWithinFrameBudget)
+{
+	if (!Pool)
+	{
+		return;
+	}
+
+	TArray<AActor*> ActorsToRecall;
+	ActorsToRecall.Reserve(Pool->ActiveActors.Num());
+	for (const FFireflyActiveActorRecord& Record : Pool->ActiveActors)
+	{
+		if (IsValid(Record.Actor))
+		{
+			ActorsToRecall.Add(Record.Actor);
+		}
+	}
+
+	ActorPool_ReleaseActors(ActorsToRecall, bWithinFrameBudget);
+}
+
+void UFireflyObjectPoolWorldSubsystem::QueueRelease(AActor* Actor)
+{
+	bool bAlreadyQueued = false;
+	PendingReleaseSet.Add(Actor, &bAlreadyQueued);
+	if (!bAlreadyQueued)
+	{
+		PendingReleaseActors.Add(Actor);
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::ProcessPendingReleases()
+{
+	if (PendingReleaseActors.Num() == 0)
+	{
+		return;
+	}
+
+	// 按最近测得的单个Actor回收耗时估算本帧预算内能回收的数量，把这些Actor收集成一批一次性回收。
+	// Estimate how many Actors fit into the budget of this frame from the recently measured cost per Actor, and release them as one batch.
+	const double Budget = CVarFireflyObjectPoolReleaseBudgetMs.GetValueOnGameThread() / 1000.0;
+	const int32 BatchSize = FMath::Clamp(FMath::FloorToInt(Budget / PendingReleaseSecondsPerActor), 1, PendingReleaseActors.Num());
+
+	TArray<AActor*> ActorsToRelease;
+	ActorsToRelease.Reserve(BatchSize);
+
+	int32 Processed = 0;
+	while (Processed < PendingReleaseActors.Num() && ActorsToRelease.Num() < BatchSize)
+	{
+		// 不在集合中的条目已经被直接回收过，Actor可能又被重新取出，不能再回收。
+		// Entries not in the set were already released directly, and the Actor may have been fetched again, so they mustn't be released.
+		const TObjectKey<AActor> Key = PendingReleaseActors[Processed++];
+		if (PendingReleaseSet.Remove(Key) == 0)
+		{
+			continue;
+		}
+
+		AActor* Actor = Key.ResolveObjectPtrEvenIfPendingKill();
+		if (!IsValid(Actor))
+		{
+			if (Actor)
+			{
+				UntrackActiveActor(Actor);
+			}
+			continue;
+		}
+
+		if (ActiveActorHandles.Contains(Actor))
+		{
+			ActorsToRelease.Add(Actor);
+		}
+	}
+
+	if (ActorsToRelease.Num() > 0)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		ActorPool_ReleaseActors(ActorsToRelease, false);
+		const double SecondsPerActor = (FPlatformTime::Seconds() - StartTime) / ActorsToRelease.Num();
+		PendingReleaseSecondsPerActor = FMath::Max(FMath::Lerp(PendingReleaseSecondsPerActor, SecondsPerActor, 0.5), 0.000001);
+	}
+
+	PendingReleaseActors.RemoveAt(0, Processed, false);
+}
+
+void UFireflyObjectPoolWorldSubsystem::SetProjectileBatched(FFireflyActorPool& Pool, int32 Index, bool bBatched)
+{
+	FFireflyBatchedProjectiles& Batch = Pool.BatchedProjectiles;
+	if (Batch.Num() < Pool.ActiveActors.Num())
+	{
+		Batch.SetNum(Pool.ActiveActors.Num());
+	}
+
+	const FFireflyActiveActorRecord& Record = Pool.ActiveActors[Index];
+	UProjectileMovementComponent* ProjectileMovement = Record.ProjectileMovement.Get();
+	if (!IsValid(Record.Actor) || !ProjectileMovement)
+	{
+		Batch.bManaged[Index] = false;
+		return;
+	}
+
+	if (bBatched)
+	{
+		const FVector Location = Record.Actor->GetActorLocation();
+		Batch.PositionX[Index] = Location.X;
+		Batch.PositionY[Index] = Location.Y;
+		Batch.PositionZ[Index] = Location.Z;
+		Batch.VelocityX[Index] = ProjectileMovement->Velocity.X;
+		Batch.VelocityY[Index] = ProjectileMovement->Velocity.Y;
+		Batch.VelocityZ[Index] = ProjectileMovement->Velocity.Z;
+		Batch.GravityZ[Index] = ProjectileMovement->GetGravityZ();
+		Batch.bRotationFollowsVelocity[Index] = ProjectileMovement->bRotationFollowsVelocity;
+		Batch.bManaged[Index] = true;
+		Batch.bActorTickWasEnabled[Index] = Record.Actor->IsActorTickEnabled();
+		Batch.bMovementTickWasEnabled[Index] = ProjectileMovement->IsComponentTickEnabled();
+
+		Record.Actor->SetActorTickEnabled(false);
+		ProjectileMovement->SetComponentTickEnabled(false);
+	}
+	else if (Batch.bManaged[Index])
+	{
+		ProjectileMovement->Velocity = FVector(Batch.VelocityX[Index], Batch.VelocityY[Index], Batch.VelocityZ[Index]);
+		Batch.bManaged[Index] = false;
+
+		// 只还原统一推进之前的Tick状态，不启用原本就关闭的Tick。
+		// Only restore the tick state from before batching, ticks that were disabled stay disabled.
+		Record.Actor->SetActorTickEnabled(Batch.bActorTickWasEnabled[Index] != 0);
+		ProjectileMovement->SetComponentTickEnabled(Batch.bMovementTickWasEnabled[Index] != 0);
+	}
+}
+
+void UFireflyObjectPoolWorldSubsystem::ApplyBatchedProjectileConfig(FFireflyActorPool& Pool,
+	TSubclassOf<AActor> PoolClass, FName PoolID, UWorld* World)
+{
+	if (!Pool.Config.bBatchProjectileMovement)
+	{
+		for (int32 i = 0; i < Pool.BatchedProjectiles.Num(); ++i)
+		{
+			SetProjectileBatched(Pool, i, false);
+		}
+		Pool.BatchedProjectiles.SetNum(0);
+		Pool.TickFunction.Reset();
+
+		return;
+	}
+
+	if (Pool.TickFunction.IsValid() || !IsValid(World))
+	{
+		return;
+	}
+
+	Pool.TickFunction = MakeUnique<FFireflyActorPoolTickFunction>();
+	Pool.TickFunction->PoolClass = PoolClass;
+	Pool.TickFunction->PoolID = PoolID;
+	Pool.TickFunction->bCanEverTick = true;
+	Pool.TickFunction->bStartWithTickEnabled = true;
+	Pool.TickFunction->TickGroup = TG_PrePhysics;
+	Pool.TickFunction->RegisterTickFunction(World->PersistentLevel);
+}
+
+void UFireflyObjectPoolWorldSubsystem::TickBatchedProjectiles(FFireflyActorPool& Pool, float DeltaTime)
+{
+	FFireflyBatchedProjectiles& Batch = Pool.BatchedProjectiles;
+	const int32 Num = FMath::Min(Batch.Num(), Pool.ActiveActors.Num());
+	if (Num == 0)
+	{
+		return;
+	}
+
+	// 玩法代码可能在批处理之外传送抛射物或修改其速度，推进前先从Actor和组件重新读取。
+	// Gameplay may teleport a projectile or change its velocity outside the batch, so re-read them from the Actor and the component before advancing.
+	for (int32 i = 0; i < Num; ++i)
+	{
+		const FFireflyActiveActorRecord& Record = Pool.ActiveActors[i];
+		const UProjectileMovementComponent* ProjectileMovement = Record.ProjectileMovement.Get();
+		if (!Batch.bManaged[i] || !IsValid(Record.Actor) || !ProjectileMovement)
+		{
+			continue;
+		}
+
+		const FVector Location = Record.Actor->GetActorLocation();
+		if (!Location.Equals(FVector(Batch.PositionX[i], Batch.PositionY[i], Batch.PositionZ[i]), UE_KINDA_SMALL_NUMBER))
+		{
+			Batch.PositionX[i] = Location.X;
+			Batch.PositionY[i] = Location.Y;
+			Batch.PositionZ[i] = Location.Z;
+		}
+		Batch.VelocityX[i] = ProjectileMovement->Velocity.X;
+		Batch.VelocityY[i] = ProjectileMovement->Velocity.Y;
+		Batch.VelocityZ[i] = ProjectileMovement->Velocity.Z;
+	}
+
+	// 运动学推进只访问连续的数组且没有分支，便于编译器向量化。
+	// The kinematics only touch contiguous arrays without branches so the compiler can vectorize them.
+	float* RESTRICT VelocityX = Batch.VelocityX.GetData();
+	float* RESTRICT VelocityY = Batch.VelocityY.GetData();
+	float* RESTRICT VelocityZ = Batch.VelocityZ.GetData();
+	const float* RESTRICT GravityZ = Batch.GravityZ.GetData();
+	double* RESTRICT PositionX = Batch.PositionX.GetData();
+	double* RESTRICT PositionY = Batch.PositionY.GetData();
+	double* RESTRICT PositionZ = Batch.PositionZ.GetData();
+
+	for (int32 i = 0; i < Num; ++i)
+	{
+		VelocityZ[i] += GravityZ[i] * DeltaTime;
+	}
+
+	for (int32 i = 0; i < Num; ++i)
+	{
+		PositionX[i] += VelocityX[i] * DeltaTime;
+		PositionY[i] += VelocityY[i] * DeltaTime;
+		PositionZ[i] += VelocityZ[i] * DeltaTime;
+	}
+
+	// 所有变换在同一个延迟作用域内写回，重叠检测和子组件变换更新在作用域结束时统一提交。
+	// All transforms are written back within one deferred scope, overlap and child transform updates are committed once when it ends.
+	FFireflyScopedActorPoolBatch MovementBatch;
+	for (int32 i = 0; i < Num; ++i)
+	{
+		if (!Batch.bManaged[i])
+		{
+			continue;
+		}
+
+		const FFireflyActiveActorRecord& Record = Pool.ActiveActors[i];
+		AActor* Actor = Record.Actor;
+		USceneComponent* RootComponent = IsValid(Actor) ? Actor->GetRootComponent() : nullptr;
+		UProjectileMovementComponent* ProjectileMovement = Record.ProjectileMovement.Get();
+		if (!RootComponent || !ProjectileMovement)
+		{
+			continue;
+		}
+
+		const FVector Velocity(VelocityX[i], VelocityY[i], VelocityZ[i]);
+		const FVector Location(PositionX[i], PositionY[i], PositionZ[i]);
+		const FVector StartLocation = Location - Velocity * DeltaTime;
+
+		// 会发生阻挡碰撞时交还给抛射物组件，由它在自己的Tick中扫掠并处理命中、反弹和停止。
+		// Hand the projectile back to its component when it would be blocked, the component sweeps and handles the hit, bounce and stop in its own tick.
+		const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(RootComponent);
+		if (Primitive && Primitive->IsQueryCollisionEnabled())
+		{
+			FComponentQueryParams QueryParams(SCENE_QUERY_STAT(FireflyBatchedProjectile), Actor);
+			FCollisionResponseParams ResponseParams;
+			Primitive->InitSweepCollisionParams(QueryParams, ResponseParams);
+
+			FHitResult Hit;
+			if (Actor->GetWorld()->SweepSingleByChannel(Hit, StartLocation, Location, Primitive->GetComponentQuat()
+				, Primitive->GetCollisionObjectType(), Primitive->GetCollisionShape(), QueryParams, ResponseParams))
+			{
+				PositionX[i] = StartLocation.X;
+				PositionY[i] = StartLocation.Y;
+				PositionZ[i] = StartLocation.Z;
+				SetProjectileBatched(Pool, i, false);
+				continue;
+			}
+		}
+
+		FFireflyScopedActorPoolBatch::DeferMovementUpdates(RootComponent);
+		if (Batch.bRotationFollowsVelocity[i])
+		{
+			RootComponent->SetWorldLocationAndRotation(Location, Velocity.Rotation());
+		}
+		else
+		{
+			RootComponent->SetWorldLocation(Location);
+		}
+		ProjectileMovement->Velocity = Velocity;
+	}
+}
+
+void FFireflyActorPool::PushActor(AActor* Actor, FName Variant)
+{
+	const int32 Index = Actors.Add(Actor);
+	if (Config.bIndexVariants)
+	{
+		ActorVariants.Add(Variant);
+		VariantSlotPositions.Add(VariantSlots.FindOrAdd(Variant).Add(Index));
+	}
+}
+
+AActor* FFireflyActorPool::PopActor(FName* OutVariant)
+{
+	if (OutVariant)
+	{
+		*OutVariant = NAME_None;
+	}
+
+	return Actors.Num() > 0 ? RemoveActorAt(Actors.Num() - 1, OutVariant) : nullptr;
+}
+
+AActor* FFireflyActorPool::PopActorOfVariant(FName Variant, FName& OutVariant)
+{
+	OutVariant = NAME_None;
+	if (!Config.bIndexVariants)
+	{
+		return PopActor();
+	}
+
+	const TArray<int32>* Slots = VariantSlots.Find(Variant);
+	if (!Slots || Slots->Num() == 0)
+	{
+		// 没有匹配的待命Actor时，选择重新配置代价最小的变体，变体的种类通常很少。
+		// With no matching Actor on standby, pick the variant cheapest to reconfigure, there are usually few variants.
+		Slots = nullptr;
+		int32 BestDistance = MAX_int32;
+		for (const TPair<FName, TArray<int32>>& Pair : VariantSlots)
+		{
+			const int32 Distance = GetVariantDistance(Pair.Key, Variant);
+			if (Pair.Value.Num() > 0 && Distance < BestDistance)
+			{
+				Slots = &Pair.Value;
+				BestDistance = Distance;
+			}
+		}
+	}
+
+	if (!Slots)
+	{
+		return nullptr;
+	}
+
+	const int32 Index = Slots->Last();
+	OutVariant = ActorVariants[Index];
+
+	return RemoveActorAt(Index);
+}
+
+AActor* FFireflyActorPool::RemoveActorAt(int32 Index, FName* OutVariant)
+{
+	AActor* Actor = Actors[Index];
+	const int32 LastIndex = Actors.Num() - 1;
+	if (OutVariant)
+	{
+		*OutVariant = Config.bIndexVariants && ActorVariants.IsValidIndex(Index) ? ActorVariants[Index] : NAME_None;
+	}
+	if (Config.bIndexVariants && ActorVariants.IsValidIndex(Index))
+	{
+		// 先把Actor从其变体的下标列表中交换移除，再把末尾Actor在下标列表中记录的下标改为Index。
+		// Swap-remove the Actor from the index list of its variant first, then point the entry of the last Actor at Index.
+		TArray<int32>& Slots = VariantSlots.FindChecked(ActorVariants[Index]);
+		const int32 Position = VariantSlotPositions[Index];
+		Slots.RemoveAtSwap(Position, 1, false);
+		if (Slots.IsValidIndex(Position))
+		{
+			VariantSlotPositions[Slots[Position]] = Position;
+		}
+
+		if (Index != LastIndex)
+		{
+			VariantSlots.FindChecked(ActorVariants[LastIndex])[VariantSlotPositions[LastIndex]] = Index;
+		}
+		ActorVariants.RemoveAtSwap(Index, 1, false);
+		VariantSlotPositions.RemoveAtSwap(Index, 1, false);
+	}
+	Actors.RemoveAtSwap(Index, 1, false);
+
+	return Actor;
+}
+
+void FFireflyActorPool::RebuildVariantIndex()
+{
+	ActorVariants.Reset();
+	VariantSlotPositions.Reset();
+	VariantSlots.Reset();
+	if (!Config.bIndexVariants)
+	{
+		return;
+	}
+
+	ActorVariants.Init(NAME_None, Actors.Num());
+	TArray<int32>& Slots = VariantSlots.Add(NAME_None);
+	for (int32 i = 0; i < Actors.Num(); ++i)
+	{
+		VariantSlotPositions.Add(Slots.Add(i));
+	}
+}
+
+int32 FFireflyActorPool::GetVariantDistance(FName From, FName To)
+{
+	if (From == To)
+	{
+		return 0;
+	}
+
+	if (From != NAME_None && From.GetComparisonIndex() == To.GetComparisonIndex())
+	{
+		return FMath::Abs(From.GetNumber() - To.GetNumber());
+	}
+
+	return MAX_int32 - 1;
+}
+
+void FFireflyActorPoolTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType,
+	ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	FFireflyActorPool* Pool = PoolID != NAME_None
+		? UFireflyObjectPoolWorldSubsystem::ActorPoolOfID.Find(PoolID)
+		: UFireflyObjectPoolWorldSubsystem::ActorPoolOfClass.Find(PoolClass);
+	if (Pool && TickType != LEVELTICK_ViewportsOnly)
+	{
+		UFireflyObjectPoolWorldSubsystem::TickBatchedProjectiles(*Pool, DeltaTime);
+	}
+}
+
+FString FFireflyActorPoolTickFunction::DiagnosticMessage()
+{
+	return FString::Printf(TEXT("FFireflyActorPoolTickFunction[%s]"), PoolID != NAME_None ? *PoolID.ToString() : *GetNameSafe(PoolClass));
+}
+
+FName FFireflyActorPoolTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return PoolID != NAME_None ? PoolID : (PoolClass ? PoolClass->GetFName() : NAME_None);
+}
+
+void UFireflyObjectPoolWorldSubsystem::EvaluateReleaseTriggers()
+{
+	UWorld* World = GetWorld();
+	const float KillZ = World->GetWorldSettings() ? World->GetWorldSettings()->KillZ : -UE_BIG_NUMBER;
+
+	TArray<AActor*> ActorsToRelease;
+	auto EvaluatePool = [World, KillZ, &ActorsToRelease](FFireflyActorPool& Pool)
+	{
+		const FFireflyActorPoolReleaseTriggers& Triggers = Pool.Config.ReleaseTriggers;
+		if (!Triggers.HasAnyTrigger())
+		{
+			return;
+		}
+
+		const float MaxDistanceSquared = FMath::Square(Triggers.MaxDistanceFromSpawn);
+
+		for (int32 i = Pool.ActiveActors.Num() - 1; i >= 0; --i)
+		{
+			FFireflyActiveActorRecord& Record = Pool.ActiveActors[i];
+			AActor* Actor = Record.Actor;
+			if (!IsValid(Actor))
+			{
+				UntrackActiveActorAt(Pool, i);
+				continue;
+			}
+
+			if (Actor->GetWorld() != World)
+			{
+				continue;
+			}
+
+			const FVector Location = Actor->GetActorLocation();
+			bool bShouldRelease = false;
+
+			if (Triggers.bReleaseOnProjectileStop)
+			{
+				const UProjectileMovementComponent* ProjectileMovement = Record.ProjectileMovement.Get();
+				bShouldRelease |= ProjectileMovement && !ProjectileMovement->UpdatedComponent;
+			}
+
+			if (Triggers.bReleaseOutOfWorldBounds)
+			{
+				bShouldRelease |= Location.Z < KillZ || (Triggers.WorldBounds.IsValid && !Triggers.WorldBounds.IsInsideOrOn(Location));
+			}
+
+			if (Triggers.MaxDistanceFromSpawn > 0.f)
+			{
+				bShouldRelease |= FVector::DistSquared(Location, Record.SpawnLocation) > MaxDistanceSquared;
+			}
+
+			if (Triggers.bReleaseOnAudioFinished)
+			{
+				// 尚未开始播放的音频不算播放完毕。
+				// Audio that hasn't started yet doesn't count as finished.
+				if (const UAudioComponent* Audio = Record.Audio.Get())
+				{
+					const bool bPlaying = Audio->IsPlaying();
+					bShouldRelease |= Record.bAudioStarted && !bPlaying;
+					Record.bAudioStarted |= bPlaying;
+				}
+			}
+
+			if (Triggers.bReleaseOnOwnerDestroyed)
+			{
+				bShouldRelease |= Record.bHadOwner && !IsValid(Actor->GetOwner());
+			}
+
+			if (bShouldRelease)
+			{
+				ActorsToRelease.Add(Actor);
+			}
+		}
+	};
+
+	for (auto& Pool : ActorPoolOfClass)
+	{
+		if (Pool.Value.ActiveActors.Num() > 0)
+		{
+			EvaluatePool(Pool.Value);
+		}
+	}
+
+	for (auto& Pool : ActorPoolOfID)
+	{
+		if (Pool.Value.ActiveActors.Num() > 0)
+		{
+			EvaluatePool(Pool.Value);
+		}
+	}
+
+	ActorPool_ReleaseActors(ActorsToRelease, false);
+}
+
+int32 UFireflyObjectPoolWorldSubsystem::ActorPool_SpawnLightweight(const UObject* WorldContextObject,
+	TSubclassOf<AActor> ActorClass, FName ActorID, const FTransform& Transform)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (!IsValid(World) || (!IsValid(ActorClass) && ActorID == NAME_None))
+	{
+		return INDEX_NONE;
+	}
+
+	FFireflyActorPool* Pool = ActorID != NAME_None ? ActorPoolOfID.Find(ActorID) : ActorPoolOfClass.Find(ActorClass);
+	UInstancedStaticMeshComponent* Component = Pool ? GetOrCreateLightweightComponent(World, *Pool) : nullptr;
+	if (!Component)
+	{
+		return INDEX_NONE;
+	}
+
+	if (IsValid(ActorClass))
+	{
+		Pool->ActorClass = ActorClass;
+	}
+
+	const int32 LightweightID = NextLightweightID++;
+	FFireflyActiveActorHandle& Handle = LightweightHandles.Add(LightweightID);
+	Handle.PoolClass = ActorID != NAME_None ? nullptr : ActorClass.Get();
+	Handle.PoolID = ActorID;
+	Handle.Index = Component->AddInstance(Transform, true);
+
+	Pool->LightweightIds.Add(LightweightID);
+	Pool->LightweightLocations.Add(Transform.GetLocation());
+
+	return LightweightID;
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_ReleaseLightweight(int32 LightweightID)
+{
+	const FFireflyActiveActorHandle* Handle = LightweightHandles.Find(LightweightID);
+	if (!Handle)
+	{
+		return;
+	}
+
+	FFireflyActorPool* Pool = Handle->PoolID != NAME_None ? ActorPoolOfID.Find(Handle->PoolID) : ActorPoolOfClass.Find(Handle->PoolClass);
+	if (Pool && Pool->LightweightIds.IsValidIndex(Handle->Index))
+	{
+		RemoveLightweightAt(*Pool, Handle->Index);
+	}
+	else
+	{
+		LightweightHandles.Remove(LightweightID);
+	}
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::ActorPool_PromoteLightweight(int32 LightweightID, AActor* Owner,
+	APawn* Instigator)
+{
+	const FFireflyActiveActorHandle* Handle = LightweightHandles.Find(LightweightID);
+	if (!Handle)
+	{
+		return nullptr;
+	}
+
+	const FName ActorID = Handle->PoolID;
+	FFireflyActorPool* Pool = ActorID != NAME_None ? ActorPoolOfID.Find(ActorID) : ActorPoolOfClass.Find(Handle->PoolClass);
+	if (!Pool || !Pool->LightweightIds.IsValidIndex(Handle->Index))
+	{
+		LightweightHandles.Remove(LightweightID);
+		return nullptr;
+	}
+
+	UInstancedStaticMeshComponent* Component = Pool->LightweightComponent.Get();
+	UWorld* World = Component ? Component->GetWorld() : nullptr;
+	UFireflyObjectPoolWorldSubsystem* Subsystem = UWorld::GetSubsystem<UFireflyObjectPoolWorldSubsystem>(World);
+	if (!Subsystem)
+	{
+		return nullptr;
+	}
+
+	FTransform Transform;
+	Component->GetInstanceTransform(Handle->Index, Transform, true);
+	const TSubclassOf<AActor> ActorClass = Pool->ActorClass;
+
+	// 生成Actor可能会使对象池所在的映射重新分配，所以先移除轻量实例。
+	// Spawning the Actor may reallocate the map the pool lives in, so remove the lightweight instance first.
+	RemoveLightweightAt(*Pool, Handle->Index);
+
+	return Subsystem->SpawnActor_Internal(ActorClass, ActorID, Transform, -1.f, Owner, Instigator);
+}
+
+AActor* UFireflyObjectPoolWorldSubsystem::ActorPool_PromoteLightweightHit(const FHitResult& Hit)
+{
+	const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+	if (!HitComponent || Hit.Item == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	auto FindLightweightID = [HitComponent, &Hit](const FFireflyActorPool& Pool)
+	{
+		return Pool.LightweightComponent.Get() == HitComponent && Pool.LightweightIds.IsValidIndex(Hit.Item)
+			? Pool.LightweightIds[Hit.Item] : INDEX_NONE;
+	};
+
+	for (const auto& Pool : ActorPoolOfClass)
+	{
+		const int32 LightweightID = FindLightweightID(Pool.Value);
+		if (LightweightID != INDEX_NONE)
+		{
+			return ActorPool_PromoteLightweight(LightweightID);
+		}
+	}
+
+	for (const auto& Pool : ActorPoolOfID)
+	{
+		const int32 LightweightID = FindLightweightID(Pool.Value);
+		if (LightweightID != INDEX_NONE)
+		{
+			return ActorPool_PromoteLightweight(LightweightID);
+		}
+	}
+
+	return nullptr;
+}
+
+int32 UFireflyObjectPoolWorldSubsystem::ActorPool_DemoteActor(AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return INDEX_NONE;
+	}
+
+	const FFireflyActorPool* Pool = FindPoolOfActor(Actor);
+	if (!Pool || !Pool->Config.LightweightMesh)
+	{
+		return INDEX_NONE;
+	}
+
+	const FName ActorID = Pooling_GetActorID(Actor);
+	const FTransform Transform = Actor->GetActorTransform();
+	const TSubclassOf<AActor> ActorClass = Actor->GetClass();
+	UWorld* World = Actor->GetWorld();
+
+	ActorPool_ReleaseActor(Actor);
+
+	return ActorPool_SpawnLightweight(World, ActorClass, ActorID, Transform);
+}
+
+UInstancedStaticMeshComponent* UFireflyObjectPoolWorldSubsystem::GetOrCreateLightweightComponent(UWorld* World,
+	FFireflyActorPool& Pool)
+{
+	if (!Pool.Config.LightweightMesh)
+	{
+		return nullptr;
+	}
+
+	UInstancedStaticMeshComponent* Component = Pool.LightweightComponent.Get();
+	if (Component && Component->GetWorld() == World)
+	{
+		return Component;
+	}
+
+	ClearLightweights(Pool);
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AActor* Host = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+	if (!IsValid(Host))
+	{
+		return nullptr;
+	}
+
+	Component = NewObject<UInstancedStaticMeshComponent>(Host);
+	Component->SetMobility(EComponentMobility::Movable);
+	Component->SetStaticMesh(Pool.Config.LightweightMesh);
+	Component->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	Host->SetRootComponent(Component);
+	Component->RegisterComponent();
+
+	Pool.LightweightComponent = Component;
+
+	return Component;
+}
+
+void UFireflyObjectPoolWorldSubsystem::RemoveLightweightAt(FFireflyActorPool& Pool, int32 Index)
+{
+	LightweightHandles.Remove(Pool.LightweightIds[Index]);
+
+	// 与活跃数组一样与末尾交换，使其余实例在组件中的索引保持不变。
+	// Swap with the last one like the active array, so the indices of the other instances in the component stay unchanged.
+	const int32 LastIndex = Pool.LightweightIds.Num() - 1;
+	UInstancedStaticMeshComponent* Component = Pool.LightweightComponent.Get();
+	if (Index != LastIndex)
+	{
+		if (FFireflyActiveActorHandle* MovedHandle = LightweightHandles.Find(Pool.LightweightIds[LastIndex]))
+		{
+			MovedHandle->Index = Index;
+		}
+
+		if (Component)
+		{
+			FTransform LastTransform;
+			Component->GetInstanceTransform(LastIndex, LastTransform, true);
+			Component->UpdateInstanceTransform(Index, LastTransform, true, false, true);
+		}
+	}
+
+	if (Component)
+	{
+		Component->RemoveInstance(LastIndex);
+	}
+
+	Pool.LightweightIds.RemoveAtSwap(Index, 1, false);
+	Pool.LightweightLocations.RemoveAtSwap(Index, 1, false);
+}
+
+void UFireflyObjectPoolWorldSubsystem::ClearLightweights(FFireflyActorPool& Pool)
+{
+	for (const int32 LightweightID : Pool.LightweightIds)
+	{
+		LightweightHandles.Remove(LightweightID);
+	}
+	Pool.LightweightIds.Empty();
+	Pool.LightweightLocations.Empty();
+
+	if (const UInstancedStaticMeshComponent* Component = Pool.LightweightComponent.Get())
+	{
+		if (AActor* Host = Component->GetOwner())
+		{
+			Host->Destroy();
+		}
+	}
+	Pool.LightweightComponent.Reset();
+}
+
+void UFireflyObjectPoolWorldSubsystem::EvaluateLightweightRelevance()
+{
+	UWorld* World = GetWorld();
+
+	TArray<FVector> ViewLocations;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	if (ViewLocations.Num() == 0)
+	{
+		return;
+	}
+
+	auto DistanceSquaredToView = [&ViewLocations](const FVector& Location)
+	{
+		double MinDistanceSquared = UE_BIG_NUMBER;
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(Location, ViewLocation));
+		}
+		return MinDistanceSquared;
+	};
+
+	TArray<int32> LightweightsToPromote;
+	TArray<AActor*> ActorsToDemote;
+	auto EvaluatePool = [World, &DistanceSquaredToView, &LightweightsToPromote, &ActorsToDemote](const FFireflyActorPool& Pool)
+	{
+		if (!Pool.Config.LightweightMesh)
+		{
+			return;
+		}
+
+		const UInstancedStaticMeshComponent* Component = Pool.LightweightComponent.Get();
+		if (Pool.Config.LightweightPromoteDistance > 0.f && Component && Component->GetWorld() == World)
+		{
+			const double PromoteDistanceSquared = FMath::Square(Pool.Config.LightweightPromoteDistance);
+			for (int32 i = 0; i < Pool.LightweightLocations.Num(); ++i)
+			{
+				if (DistanceSquaredToView(Pool.LightweightLocations[i]) < PromoteDistanceSquared)
+				{
+					LightweightsToPromote.Add(Pool.LightweightIds[i]);
+				}
+			}
+		}
+
+		if (Pool.Config.LightweightDemoteDistance > 0.f)
+		{
+			const double DemoteDistanceSquared = FMath::Square(Pool.Config.LightweightDemoteDistance);
+			for (const FFireflyActiveActorRecord& Record : Pool.ActiveActors)
+			{
+				if (IsValid(Record.Actor) && Record.Actor->GetWorld() == World
+					&& DistanceSquaredToView(Record.Actor->GetActorLocation()) > DemoteDistanceSquared)
+				{
+					ActorsToDemote.Add(Record.Actor);
+				}
+			}
+		}
+	};
+
+	for (const auto& Pool : ActorPoolOfClass)
+	{
+		EvaluatePool(Pool.Value);
+	}
+
+	for (const auto& Pool : ActorPoolOfID)
+	{
+		EvaluatePool(Pool.Value);
+	}
+
+	for (AActor* Actor : ActorsToDemote)
+	{
+		ActorPool_DemoteActor(Actor);
+	}
+
+	for (const int32 LightweightID : LightweightsToPromote)
+	{
+		ActorPool_PromoteLightweight(LightweightID);
+	}
+}
+
+TArray<TSubclassOf<AActor>> UFireflyObjectPoolWorldSubsystem::ActorPool_DebugActorClasses()
+{
+	TArray<TSubclassOf<AActor>> ActorClasses;
+	ActorPoolOfClass.GetKeys(ActorClasses);
+
+	return ActorClasses;
+}
+
+TArray<FName> UFireflyObjectPoolWorldSubsystem::ActorPool_DebugActorIDs()
+{
+	TArray<FName> ActorIDs;
+	ActorPoolOfID.GetKeys(ActorIDs);
+
+	return ActorIDs;
+}
+
+int32 UFireflyObjectPoolWorldSubsystem::ActorPool_DebugActorNumberOfClass(TSubclassOf<AActor> ActorClass)
+{
+	if (!ActorPoolOfClass.Contains(ActorClass))
+	{
+		return -1;
+	}
+
+	return ActorPoolOfClass[ActorClass].Actors.Num();
+}
+
+int32 UFireflyObjectPoolWorldSubsystem::ActorPool_DebugActorNumberOfID(FName ActorID)
+{
+	if (!ActorPoolOfID.Contains(ActorID))
+	{
+		return -1;
+	}
+
+	return ActorPoolOfID[ActorID].Actors.Num();
+}
+
+float UFireflyObjectPoolWorldSubsystem::ActorPool_DebugMemoryOfClass(TSubclassOf<AActor> ActorClass)
+{
+	FFireflyActorPool* Pool = ActorPoolOfClass.Find(ActorClass);
+	if (!Pool)
+	{
+		return -1.f;
+	}
+
+	SamplePool(*Pool);
+
+	return Pool->GetEstimatedBytes() / (1024.f * 1024.f);
+}
+
+float UFireflyObjectPoolWorldSubsystem::ActorPool_DebugMemoryOfID(FName ActorID)
+{
+	FFireflyActorPool* Pool = ActorPoolOfID.Find(ActorID);
+	if (!Pool)
+	{
+		return -1.f;
+	}
+
+	SamplePool(*Pool);
+
+	return Pool->GetEstimatedBytes() / (1024.f * 1024.f);
+}
+
+float UFireflyObjectPoolWorldSubsystem::ActorPool_DebugMemoryTotal()
+{
+	int64 TotalBytes = 0;
+	for (auto& Pool : ActorPoolOfClass)
+	{
+		SamplePool(Pool.Value);
+		TotalBytes += Pool.Value.GetEstimatedBytes();
+	}
+
+	for (auto& Pool : ActorPoolOfID)
+	{
+		SamplePool(Pool.Value);
+		TotalBytes += Pool.Value.GetEstimatedBytes();
+	}
+
+	return TotalBytes / (1024.f * 1024.f);
+}
+
+void UFireflyObjectPoolWorldSubsystem::ActorPool_DumpMemory(FOutputDevice& Ar)
+{
+	Ar.Logf(TEXT("FireflyObjectPool memory report:"));
+	Ar.Logf(TEXT("%-48s %8s %12s %12s %8s %8s"), TEXT("Pool"), TEXT("Count"), TEXT("PerActorKB"), TEXT("TotalMB"), TEXT("Borrowed"), TEXT("Lent"));
+
+	int64 TotalBytes = 0;
+	auto DumpPool = [&Ar, &TotalBytes](const FString& PoolName, FFireflyActorPool& Pool)
+	{
+		SamplePool(Pool);
+		TotalBytes += Pool.GetEstimatedBytes();
+		Ar.Logf(TEXT("%-48s %8d %12.2f %12.2f %8d %8d"), *PoolName, Pool.Actors.Num()
+			, FMath::Max<int64>(Pool.SampledActorBytes, 0) / 1024.f, Pool.GetEstimatedBytes() / (1024.f * 1024.f)
+			, Pool.NumBorrowed, Pool.NumLent);
+	};
+
+	for (auto& Pool : ActorPoolOfClass)
+	{
+		DumpPool(FString::Printf(TEXT("Class:%s"), *GetNameSafe(Pool.Key)), Pool.Value);
+	}
+
+	for (auto& Pool : ActorPoolOfID)
+	{
+		DumpPool(FString::Printf(TEXT("ID:%s"), *Pool.Key.ToString()), Pool.Value);
+	}
+
+	Ar.Logf(TEXT("Total estimated memory of actor pools: %.2f MB"), TotalBytes / (1024.f * 1024.f));
+
+	const float BudgetMegabytes = CVarFireflyObjectPoolDormantBudgetMB.GetValueOnGameThread();
+	if (BudgetMegabytes > 0.f)
+	{
+		Ar.Logf(TEXT("Global dormant budget of actor pools: %.2f MB"), BudgetMegabytes);
+	}
+}
+
+int64 UFireflyObjectPoolWorldSubsystem::SampleActorBytes(const AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return 0;
+	}
+
+	auto SampleObject = [](UObject* Object) -> int64
+	{
+		FArchiveCountMem CountMem(Object);
+		return CountMem.GetMax() + Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	};
+
+	AActor* MutableActor = const_cast<AActor*>(Actor);
+	int64 Bytes = SampleObject(MutableActor);
+
+	TInlineComponentArray<UActorComponent*> Components;
+	MutableActor->GetComponents(Components);
+	for (UActorComponent* Component : Components)
+	{
+		Bytes += SampleObject(Component);
+	}
+
+	return Bytes;
+}
+
+void UFireflyObjectPoolWorldSubsystem::SamplePool(FFireflyActorPool& Pool, const AActor* Actor)
+{
+	if (Pool.SampledActorBytes > 0)
+	{
+		return;
+	}
+
+	if (!Actor && Pool.Actors.Num() > 0)
+	{
+		Actor = Pool.Actors.Last();
+	}
+
+	if (IsValid(Actor))
+	{
+		Pool.SampledActorBytes = SampleActorBytes(Actor);
+	}
+}
+
+FFireflyScopedActorPoolBatch* FFireflyScopedActorPoolBatch::CurrentBatch = nullptr;
+
+FFireflyScopedActorPoolBatch::FFireflyScopedActorPoolBatch()
+	: OuterBatch(CurrentBatch)
+{
+	CurrentBatch = this;
+}
+
+FFireflyScopedActorPoolBatch::~FFireflyScopedActorPoolBatch()
+{
+	// 按创建的相反顺序结束移动作用域，提交被推迟的重叠检测和子组件变换更新。
+	// End the movement scopes in reverse order of creation to commit the deferred overlap and child transform updates.
+	for (int32 i = MovementScopes.Num() - 1; i >= 0; --i)
+	{
+		MovementScopes[i].Reset();
+	}
+
+	CurrentBatch = OuterBatch;
+
+	// 变换提交之后再激活Actor，使PoolingBeginPlay中的移动、附加、回收和销毁都作用于已提交的状态。
+	// Activate the Actors only after the transforms are committed, so moves, attachments, releases and destroys in PoolingBeginPlay act on committed state.
+	for (TFunction<void()>& Activation : PendingActivations)
+	{
+		Activation();
+	}
+}
+
+bool FFireflyScopedActorPoolBatch::DeferActivation(TFunction<void()>&& Activation)
+{
+	if (!CurrentBatch)
+	{
+		return false;
+	}
+
+	CurrentBatch->PendingActivations.Add(MoveTemp(Activation));
+
+	return true;
+}
+
+void FFireflyScopedActorPoolBatch::DeferMovementUpdates(USceneComponent* Component)
+{
+	if (CurrentBatch && IsValid(Component))
+	{
+		CurrentBatch->MovementScopes.Add(MakeUnique<FScopedMovementUpdate>(Component, EScopedUpdate::DeferredUpdates));
+	}
 }
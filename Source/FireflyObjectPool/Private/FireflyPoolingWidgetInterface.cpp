@@ -0,0 +1,4 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#include "FireflyPoolingWidgetInterface.h"
+
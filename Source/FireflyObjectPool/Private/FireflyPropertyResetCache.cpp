@@ -0,0 +1,201 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#include "FireflyPropertyResetCache.h"
+
+#include "Components/ActorComponent.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "UObject/UnrealType.h"
+
+
+TMap<TObjectKey<UClass>, TUniquePtr<FFireflyPropertyResetCache>> FFireflyPropertyResetCache::CacheOfClass;
+
+FFireflyPropertyResetCache::~FFireflyPropertyResetCache()
+{
+	if (!Baseline)
+	{
+		return;
+	}
+
+	for (const FProperty* Property : ConstructedProperties)
+	{
+		Property->DestroyValue_InContainer(Baseline);
+	}
+	FMemory::Free(Baseline);
+}
+
+void FFireflyPropertyResetCache::CaptureBaseline(UWorld* World, TSubclassOf<AActor> ActorClass)
+{
+	if (!IsValid(World) || !IsValid(ActorClass) || CacheOfClass.Contains(ActorClass))
+	{
+		return;
+	}
+
+	// 延迟构造后只执行构造，探测实例不会执行组件初始化和BeginPlay。
+	// Defer construction and run only the construction, the probe never runs component initialization or BeginPlay.
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.bDeferConstruction = true;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+
+	TUniquePtr<FFireflyPropertyResetCache> Cache = MakeUnique<FFireflyPropertyResetCache>();
+	if (AActor* Probe = World->SpawnActor<AActor>(ActorClass, FTransform::Identity, SpawnParameters))
+	{
+		Probe->ExecuteConstruction(FTransform::Identity, nullptr, nullptr, true);
+		Cache->Build(Probe);
+		Probe->Destroy(true);
+	}
+	CacheOfClass.Add(ActorClass.Get(), MoveTemp(Cache));
+}
+
+int32 FFireflyPropertyResetCache::ResetToBaseline(AActor* Actor)
+{
+	const TUniquePtr<FFireflyPropertyResetCache>* Cache = IsValid(Actor) ? CacheOfClass.Find(Actor->GetClass()) : nullptr;
+	if (!Cache)
+	{
+		return 0;
+	}
+
+	const FFireflyPropertyResetCache& ClassCache = **Cache;
+	const uint8* ActorMemory = reinterpret_cast<const uint8*>(Actor);
+
+	int32 NumRestored = 0;
+	for (const FPlainRange& Range : ClassCache.PlainRanges)
+	{
+		if (FMemory::Memcmp(ActorMemory + Range.Start, Range.BaselineContainer + Range.Start, Range.End - Range.Start) == 0)
+		{
+			continue;
+		}
+
+		for (int32 i = Range.FirstProperty; i <= Range.LastProperty; ++i)
+		{
+			NumRestored += RestoreProperty(ClassCache.Properties[i], Actor, ClassCache.BaselineContainers[i]);
+		}
+	}
+
+	for (const int32 i : ClassCache.ComplexProperties)
+	{
+		NumRestored += RestoreProperty(ClassCache.Properties[i], Actor, ClassCache.BaselineContainers[i]);
+	}
+
+	return NumRestored;
+}
+
+int32 FFireflyPropertyResetCache::RestoreProperty(const FProperty* Property, void* Container, const void* BaselineContainer)
+{
+	int32 NumRestored = 0;
+	for (int32 Index = 0; Index < Property->ArrayDim; ++Index)
+	{
+		void* Value = Property->ContainerPtrToValuePtr<void>(Container, Index);
+		const void* BaselineValue = Property->ContainerPtrToValuePtr<void>(BaselineContainer, Index);
+		if (!Property->Identical(Value, BaselineValue, PPF_None))
+		{
+			Property->CopySingleValue(Value, BaselineValue);
+			++NumRestored;
+		}
+	}
+
+	return NumRestored;
+}
+
+void FFireflyPropertyResetCache::ClearAll()
+{
+	CacheOfClass.Empty();
+}
+
+bool FFireflyPropertyResetCache::IsResettableProperty(const FProperty* Property)
+{
+	static const FName EnginePackageName(TEXT("/Script/Engine"));
+
+	// 引擎Actor基类的属性由对象池的通用操作负责，不在这里还原。
+	// Properties of the engine Actor base classes are handled by the universal pool operations, not restored here.
+	const UClass* OwnerClass = Property->GetOwnerClass();
+	if (!OwnerClass || OwnerClass->GetOutermost()->GetFName() == EnginePackageName)
+	{
+		return false;
+	}
+
+	if (Property->HasAnyPropertyFlags(CPF_Deprecated | CPF_DuplicateTransient | CPF_InstancedReference | CPF_ContainsInstancedReference)
+		|| Property->GetFName() == UBlueprintGeneratedClass::GetUberGraphFrameName())
+	{
+		return false;
+	}
+
+	if (Property->IsA<FDelegateProperty>() || Property->IsA<FMulticastDelegateProperty>())
+	{
+		return false;
+	}
+
+	// 对象引用（包括容器和结构体中的）在不同实例间不能共享，例如构造脚本中创建的动态材质实例。
+	// Object references (including the ones inside containers and structs) can't be shared between instances, such as a dynamic material instance created by the construction script.
+	TArray<const FStructProperty*> EncounteredStructProps;
+	return !Property->ContainsObjectReference(EncounteredStructProps, EPropertyObjectReferenceType::Strong | EPropertyObjectReferenceType::Weak);
+}
+
+void FFireflyPropertyResetCache::Build(const AActor* ConstructedActor)
+{
+	const UClass* Class = ConstructedActor->GetClass();
+	const uint8* ClassDefault = reinterpret_cast<const uint8*>(Class->GetDefaultObject());
+
+	for (TFieldIterator<FProperty> It(Class); It; ++It)
+	{
+		if (IsResettableProperty(*It))
+		{
+			Properties.Add(*It);
+		}
+	}
+	Properties.Sort([](const FProperty& A, const FProperty& B) { return A.GetOffset_ForInternal() < B.GetOffset_ForInternal(); });
+
+	Baseline = static_cast<uint8*>(FMemory::Malloc(FMath::Max(Class->GetPropertiesSize(), 1), FMath::Max(Class->GetMinAlignment(), 16)));
+	FMemory::Memzero(Baseline, FMath::Max(Class->GetPropertiesSize(), 1));
+	for (const FProperty* Property : Properties)
+	{
+		bool bIdentical = true;
+		for (int32 Index = 0; Index < Property->ArrayDim && bIdentical; ++Index)
+		{
+			bIdentical = Property->Identical_InContainer(ConstructedActor, ClassDefault, Index, PPF_None);
+		}
+
+		if (bIdentical)
+		{
+			BaselineContainers.Add(ClassDefault);
+			continue;
+		}
+
+		Property->InitializeValue_InContainer(Baseline);
+		Property->CopyCompleteValue_InContainer(Baseline, ConstructedActor);
+		ConstructedProperties.Add(Property);
+		BaselineContainers.Add(Baseline);
+	}
+
+	// 把偏移相邻且基线容器相同的平凡属性合并为一个区间，其余属性逐个比较。
+	// Merge adjacent plain-old-data properties sharing a baseline container into one range, the other properties are compared one by one.
+	for (int32 i = 0; i < Properties.Num(); ++i)
+	{
+		const FProperty* Property = Properties[i];
+		if (!Property->HasAnyPropertyFlags(CPF_IsPlainOldData))
+		{
+			ComplexProperties.Add(i);
+			continue;
+		}
+
+		const int32 Start = Property->GetOffset_ForInternal();
+		const int32 End = Start + Property->GetSize();
+		FPlainRange* LastRange = PlainRanges.Num() > 0 ? &PlainRanges.Last() : nullptr;
+		if (LastRange && LastRange->LastProperty == i - 1 && LastRange->BaselineContainer == BaselineContainers[i]
+			&& Start <= LastRange->End)
+		{
+			LastRange->End = FMath::Max(LastRange->End, End);
+			LastRange->LastProperty = i;
+			continue;
+		}
+
+		FPlainRange& Range = PlainRanges.AddDefaulted_GetRef();
+		Range.Start = Start;
+		Range.End = End;
+		Range.FirstProperty = i;
+		Range.LastProperty = i;
+		Range.BaselineContainer = BaselineContainers[i];
+	}
+}
@@ -0,0 +1,75 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+
+/** 每个Actor类的属性重置缓存，记录构造完成后与类默认对象不同的属性，回收时只还原发生变化的属性 */
+/** Per-class property reset cache, records the properties that differ from the class default object after construction and restores only the changed properties on release */
+class FFireflyPropertyResetCache
+{
+public:
+	~FFireflyPropertyResetCache();
+
+	// 如果类尚未记录基线，则生成一个只执行构造、不执行BeginPlay的探测实例，记录它与类默认对象不同的属性值作为基线，随后销毁探测实例。
+	// If the class has no baseline yet, spawn a probe instance that runs construction but not BeginPlay, record its property values that differ from the class default object as the baseline, then destroy the probe.
+	static void CaptureBaseline(UWorld* World, TSubclassOf<AActor> ActorClass);
+
+	// 把Actor中与基线不同的属性还原为基线值，返回被还原的属性数量。
+	// Restore the properties of the Actor that differ from the baseline, returns the number of restored properties.
+	static int32 ResetToBaseline(AActor* Actor);
+
+	// 清空所有类的基线。
+	// Clear the baselines of all classes.
+	static void ClearAll();
+
+private:
+	// 属性是否可以安全地从基线复制到另一个实例，包含对象引用的属性都不会被还原。
+	// Whether the property can be safely copied from the baseline to another instance, properties containing object references are never restored.
+	static bool IsResettableProperty(const FProperty* Property);
+
+	// 逐个元素比较属性，不同时从基线复制，返回被还原的元素数量。
+	// Compare the property element by element and copy from the baseline where they differ, returns the number of restored elements.
+	static int32 RestoreProperty(const FProperty* Property, void* Container, const void* BaselineContainer);
+
+	void Build(const AActor* ConstructedActor);
+
+	/** 连续的平凡属性合并成的内存区间，回收时先整体比较，只有发生变化的区间才逐个属性检查 */
+	/** Memory range of contiguous plain-old-data properties, compared as a whole on release and checked per property only if it changed */
+	struct FPlainRange
+	{
+		int32 Start = 0;
+
+		int32 End = 0;
+
+		int32 FirstProperty = 0;
+
+		int32 LastProperty = 0;
+
+		const uint8* BaselineContainer = nullptr;
+	};
+
+	// 预先计算的可还原属性列表，按偏移排序。
+	// Precomputed list of resettable properties, sorted by offset.
+	TArray<const FProperty*> Properties;
+
+	// 每个属性的基线所在的容器。构造后与类默认对象相同的属性直接以类默认对象为基线，否则以Baseline为基线。
+	// Container holding the baseline of every property. Properties equal to the class default object after construction use the class default object as their baseline, the others use Baseline.
+	TArray<const uint8*> BaselineContainers;
+
+	TArray<FPlainRange> PlainRanges;
+
+	// 非平凡属性（字符串、数组等）在Properties中的下标，每次回收逐个比较。
+	// Indices in Properties of the non-plain properties (strings, arrays, etc.), compared one by one on every release.
+	TArray<int32> ComplexProperties;
+
+	// 构造后与类默认对象不同的属性的基线值，与Actor的内存布局相同。其中不包含任何对象引用，所以不需要向GC报告。
+	// Baseline values of the properties that differ from the class default object after construction, laid out like the Actor. It holds no object references, so there is nothing to report to GC.
+	uint8* Baseline = nullptr;
+
+	TArray<const FProperty*> ConstructedProperties;
+
+	static TMap<TObjectKey<UClass>, TUniquePtr<FFireflyPropertyResetCache>> CacheOfClass;
+};
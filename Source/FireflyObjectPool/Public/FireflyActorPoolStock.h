@@ -0,0 +1,55 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "FireflyActorPoolStock.generated.h"
+
+/** 烘焙进关卡的一个对象池的待命Actor */
+/** Actors on standby of one pool baked into the level */
+USTRUCT(BlueprintType)
+struct FIREFLYOBJECTPOOL_API FFireflyActorPoolStockEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "FireflyObjectPool")
+	TSubclassOf<AActor> ActorClass;
+
+	// 为None时放进Actor类对象池，否则放进对应ID的对象池。
+	// Put into the class-based pool if None, otherwise into the pool of this ID.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "FireflyObjectPool")
+	FName ActorID = NAME_None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "FireflyObjectPool", Meta = (ClampMin = "0"))
+	int32 Count = 16;
+
+	// 在编辑器中保存关卡时预先放置在关卡中的待命Actor。
+	// Actors on standby pre-placed in the level when the level is saved in the editor.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "FireflyObjectPool")
+	TArray<TObjectPtr<AActor>> BakedActors;
+};
+
+/** 放置在关卡中，在编辑器中保存关卡时把配置的对象池待命Actor作为关卡中的Actor预先放置（烘焙时只做检查），加载关卡时由对象池直接接管而无需生成 */
+/** Placed in a level, the configured pools' Actors on standby are pre-placed as level Actors when the level is saved in the editor (cooking only verifies them), and adopted directly by the object pool on load without spawning */
+UCLASS(HideCategories = (Actor, Input, Replication, Rendering, Collision, HLOD, Physics, LevelInstance, Cooking, DataLayers, WorldPartition))
+class FIREFLYOBJECTPOOL_API AFireflyActorPoolStock : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AFireflyActorPoolStock();
+
+	// 在关卡中任何Actor开始BeginPlay之前把预先放置的Actor交给对象池。
+	// Hand the pre-placed Actors over to the object pool before any Actor of the level begins play.
+	virtual void PostInitializeComponents() override;
+
+	// 该关卡中要预先放置的对象池待命Actor。
+	// Actors on standby of the pools to pre-place in this level.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "FireflyObjectPool")
+	TArray<FFireflyActorPoolStockEntry> Entries;
+
+	// 已预先放置的Actor是否与配置一致。
+	// Whether the pre-placed Actors match the configuration.
+	bool IsStockUpToDate() const;
+};
@@ -35,6 +35,49 @@ public:
 #pragma endregion
 
 
+#pragma region Server_Pool_Operation
+
+	// 当前世界是否为专用服务器，并且没有全局关闭剥离表现组件（Firefly.ObjectPool.StripCosmeticsOnServer）。是否剥离还取决于对象池的bStripCosmeticsOnServer。
+	// Whether the current world is a dedicated server without cosmetic stripping turned off globally (Firefly.ObjectPool.StripCosmeticsOnServer). Whether anything is stripped also depends on bStripCosmeticsOnServer of the pool.
+	UFUNCTION(BlueprintPure, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static bool ShouldStripCosmetics(const UObject* WorldContextObject);
+
+	// 组件是否为专用服务器上无用的表现组件（特效、音频、贴花）。
+	// Whether the component is a cosmetic component useless on a dedicated server (FX, audio, decal).
+	static bool IsCosmeticComponent(const UActorComponent* Component);
+
+	// 在专用服务器上剥离Actor中可以安全移除的表现组件（不是根组件，也没有附加的子组件），返回被剥离的组件数量。默认子对象和蓝图组件被注销并关闭自动激活，其余没有被Actor属性引用的组件被销毁。
+	// Strip the cosmetic components of the Actor that can be removed safely (not the root and without attached children) on a dedicated server, returns the number of stripped components. Default subobjects and Blueprint components are unregistered with auto activation turned off, the other components no property of the Actor references are destroyed.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static int32 StripCosmeticComponents(const UObject* WorldContextObject, AActor* Actor);
+
+#pragma endregion
+
+
+#pragma region Component_Universal_Pool_Operation
+
+	// Component通用的从对象池中取出后进行初始化的操作。
+	// Common operation for a Component to initialize after being taken out from the object pool.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static void UniversalBeginPlay_Component(const UObject* WorldContextObject, UActorComponent* Component);
+
+	// Component通用的回到对象池后进入冻结状态的操作。
+	// Common operation for a Component to enter a frozen state after returning to the object pool.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static void UniversalEndPlay_Component(const UObject* WorldContextObject, UActorComponent* Component);
+
+	// Component通用的在对象池中生成后进入待命状态的操作。
+	// Common operation for a Component to enter a standby state after being generated in the object pool.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static void UniversalWarmUp_Component(const UObject* WorldContextObject, UActorComponent* Component);
+
+	// 把保留下来的动画实例重置为初始状态：动画蓝图中不含对象引用的变量还原为类默认值，再重新初始化动画图表使状态机回到入口状态。不会重新创建动画实例。
+	// Reset a preserved anim instance to its initial state: the Anim Blueprint variables without object references are restored to the class defaults, then the anim graph is initialized again so the state machines return to their entry states. The anim instance isn't recreated.
+	static void ResetAnimInstance(class UAnimInstance* AnimInstance);
+
+#pragma endregion
+
+
 #pragma region Pawn_Universal_Pool_Operation
 
 	// Pawn通用的从对象池中取出后进行初始化的操作。
@@ -42,8 +85,8 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
 	static void UniversalBeginPlay_Pawn(const UObject* WorldContextObject, APawn* Pawn);
 
-	// Pawn通用的回到对象池后进入冻结状态的操作。
-	// Common operation for an Pawn to enter a frozen state after returning to the object pool.
+	// Pawn通用的回到对象池后进入冻结状态的操作。AI控制器保持占有Pawn并暂停逻辑、感知和群体避让，取出时重置黑板并重新运行行为树。
+	// Common operation for an Pawn to enter a frozen state after returning to the object pool. The AI controller keeps possessing the Pawn with its logic, perception and crowd avoidance paused, the blackboard is reset and the behavior tree rerun on fetch.
 	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
 	static void UniversalEndPlay_Pawn(const UObject* WorldContextObject, APawn* Pawn);
 
@@ -62,8 +105,8 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
 	static void UniversalBeginPlay_Character(const UObject* WorldContextObject, ACharacter* Character);
 
-	// Character通用的回到对象池后进入冻结状态的操作。
-	// Common operation for an Character to enter a frozen state after returning to the object pool.
+	// Character通用的回到对象池后进入冻结状态的操作。骨骼网格体保留动画实例并停止动画更新和骨骼刷新，角色移动保留UpdatedComponent以便快速恢复。
+	// Common operation for an Character to enter a frozen state after returning to the object pool. Skeletal meshes keep their anim instance and stop anim updates and bone refreshes, the character movement keeps its UpdatedComponent for a quick restore.
 	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
 	static void UniversalEndPlay_Character(const UObject* WorldContextObject, ACharacter* Character);
 
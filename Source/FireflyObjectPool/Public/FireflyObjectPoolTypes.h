@@ -0,0 +1,462 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Engine/EngineTypes.h"
+#include "Templates/SubclassOf.h"
+#include "FireflyObjectPoolTypes.generated.h"
+
+class AActor;
+class APawn;
+class UAudioComponent;
+class UInstancedStaticMeshComponent;
+class UProjectileMovementComponent;
+class UStaticMesh;
+class UUserWidget;
+class SWidget;
+
+/** 对象池统一检测的Actor自动回收条件 */
+/** Auto-release triggers of pooled Actors evaluated centrally by the object pool */
+USTRUCT(BlueprintType)
+struct FIREFLYOBJECTPOOL_API FFireflyActorPoolReleaseTriggers
+{
+	GENERATED_BODY()
+
+	// ProjectileMovement组件停止运动时回收Actor。
+	// Release the Actor when its ProjectileMovement component stops.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bReleaseOnProjectileStop = false;
+
+	// Actor低于世界的KillZ，或者离开WorldBounds（如果有效）时回收Actor。
+	// Release the Actor when it's below the KillZ of the world, or leaves WorldBounds (if valid).
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bReleaseOutOfWorldBounds = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool", Meta = (EditCondition = "bReleaseOutOfWorldBounds"))
+	FBox WorldBounds = FBox(ForceInit);
+
+	// Actor距离生成位置超过该距离时回收Actor，小于等于0表示不检测。
+	// Release the Actor when it's farther than this distance from its spawn location, less than or equal to 0 means no check.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	float MaxDistanceFromSpawn = 0.f;
+
+	// Actor的音频组件播放完毕时回收Actor。
+	// Release the Actor when its audio component has finished playing.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bReleaseOnAudioFinished = false;
+
+	// 生成时指定的Owner被销毁时回收Actor。
+	// Release the Actor when the Owner specified on spawn is destroyed.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bReleaseOnOwnerDestroyed = false;
+
+	bool HasAnyTrigger() const
+	{
+		return bReleaseOnProjectileStop || bReleaseOutOfWorldBounds || MaxDistanceFromSpawn > 0.f
+			|| bReleaseOnAudioFinished || bReleaseOnOwnerDestroyed;
+	}
+};
+
+/** Actor池的配置 */
+/** Configuration of an actor pool */
+USTRUCT(BlueprintType)
+struct FIREFLYOBJECTPOOL_API FFireflyActorPoolConfig
+{
+	GENERATED_BODY()
+
+	// 对象池中待命Actor的最大数量，小于等于0表示不限制。
+	// Max number of Actors on standby in the pool, less than or equal to 0 means unlimited.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	int32 MaxCount = 0;
+
+	// 对象池中待命Actor估算占用内存的上限（MB），小于等于0表示不限制。
+	// Upper limit of the estimated memory (MB) of Actors on standby in the pool, less than or equal to 0 means unlimited.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	float MaxMegabytes = 0.f;
+
+	// 对象池未命中和预热时，是否复制一个已执行过构造的模板实例生成新Actor，而不是从类默认对象生成。复制得到的Actor不会再执行SCS和构造脚本，也不会触发UWorld的OnActorSpawned，延迟构造的生成不受影响。
+	// Whether new Actors are spawned by duplicating a constructed template instance instead of the class defaults on pool misses and warm-up. Duplicated Actors don't run the SCS or the construction script again and don't raise OnActorSpawned of UWorld, deferred spawns are unaffected.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bSpawnFromTemplate = false;
+
+	// 是否在Actor回收时把其中构造后发生变化的属性还原为构造完成时的值，只会检查和复制每个类预先计算的可还原属性列表。包含对象引用的属性不会被还原，需要在PoolingEndPlay中自行处理。
+	// Whether the properties changed since construction are restored to their post-construction values when the Actor is released, only the precomputed list of resettable properties of each class is checked and copied. Properties containing object references aren't restored and must be handled in PoolingEndPlay.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bResetPropertiesOnRelease = false;
+
+	// 是否在专用服务器上剥离该对象池Actor的表现组件（特效、音频、贴花）。默认子对象和蓝图组件只会被注销并关闭自动激活，只有没有被任何属性引用的运行时组件才会被销毁。
+	// Whether the cosmetic components (FX, audio, decal) of the pool's Actors are stripped on a dedicated server. Default subobjects and Blueprint components are only unregistered with auto activation turned off, only runtime components no property references are destroyed.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bStripCosmeticsOnServer = false;
+
+	// 是否由对象池统一推进所有正在使用的Actor的ProjectileMovement简单运动学（速度和重力），并关闭这些Actor和组件各自的Tick。对象池只检测阻挡碰撞，会发生碰撞的抛射物交还给组件自己处理命中、反弹和停止。不支持追踪。
+	// Whether the pool advances the simple kinematics (velocity and gravity) of the ProjectileMovement of all its Actors in use in one batch and turns off their own ticks. The pool only checks for blocking hits, projectiles about to hit are handed back to their component to handle the hit, bounce and stop. Homing isn't supported.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bBatchProjectileMovement = false;
+
+	// 轻量实例使用的静态网格体。有效时对象池可以把不需要参与玩法的实例表示为共享的InstancedStaticMeshComponent中的一个实例，而不是一个完整的Actor。
+	// Static mesh of lightweight instances. If valid, the pool can represent instances that aren't gameplay-relevant as an instance of a shared InstancedStaticMeshComponent instead of a full Actor.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	TObjectPtr<UStaticMesh> LightweightMesh;
+
+	// 有玩家视点进入该距离时把轻量实例提升为池化Actor，小于等于0表示不自动提升。
+	// Promote a lightweight instance to a pooled Actor when a player viewpoint comes within this distance, less than or equal to 0 means no automatic promotion.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool", Meta = (EditCondition = "LightweightMesh != nullptr"))
+	float LightweightPromoteDistance = 0.f;
+
+	// 所有玩家视点都离开该距离时把正在使用的池化Actor降级为轻量实例，应大于提升距离以避免反复切换，小于等于0表示不自动降级。
+	// Demote a pooled Actor in use to a lightweight instance when all player viewpoints are beyond this distance, should be larger than the promote distance to avoid flip-flopping, less than or equal to 0 means no automatic demotion.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool", Meta = (EditCondition = "LightweightMesh != nullptr"))
+	float LightweightDemoteDistance = 0.f;
+
+	// 待命Actor数量的低水位。预测的需求会使待命数量低于低水位时，子系统在每帧的补充预算内于后台生成Actor补充对象池，小于等于0表示不补充。
+	// Low watermark of the number of Actors on standby. When the predicted demand would drain the pool below it, the subsystem refills the pool in the background within the per-frame refill budget, less than or equal to 0 means no refill.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	int32 LowWatermark = 0;
+
+	// 后台补充的目标数量，预测需求较高时会提高到低水位加上预测需求。
+	// Target number of the background refill, raised to the low watermark plus the predicted demand when the demand is higher.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool", Meta = (EditCondition = "LowWatermark > 0"))
+	int32 HighWatermark = 0;
+
+	// 是否在对象池的待命Actor一段时间没有变化后把它们组成GC簇，垃圾回收时不再逐个遍历它们的引用，取出或回收Actor时解散。只有类允许加入簇（bCanBeInCluster）的Actor及其组件会加入簇。
+	// Whether the Actors on standby in the pool are grouped into a GC cluster once they haven't changed for a while, so garbage collection no longer traverses their references one by one, dissolved when an Actor is taken out or released. Only Actors whose class allows clustering (bCanBeInCluster) and their components join the cluster.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bClusterDormantActors = false;
+
+	// ActorID对象池未命中时，是否从同一Actor类的其他ActorID对象池借用一个待命Actor并改为本对象池的ActorID。出借的对象池会保留不少于其低水位的待命Actor。
+	// Whether an ID-based pool borrows an Actor on standby from another ID-based pool of the same Actor class on a miss and re-tags it with its own ActorID. The lending pool keeps at least its low watermark of Actors on standby.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bBorrowFromSameClass = false;
+
+	// 是否在无缝切换地图时保留对象池中待命的Actor，由目标世界的子系统接管。需要在GameMode的GetSeamlessTravelActorList中加入ActorPool_GetSeamlessTravelActors返回的Actor。
+	// Whether the Actors on standby in the pool are kept through seamless travel and adopted by the subsystem of the destination world. The Actors returned by ActorPool_GetSeamlessTravelActors must be added in GetSeamlessTravelActorList of the GameMode.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bKeepAcrossSeamlessTravel = false;
+
+	// 所有对象池的待命Actor超出全局内存预算（Firefly.ObjectPool.DormantBudgetMB）时的淘汰优先级，优先级低且最久未使用的对象池先被淘汰。优先级大于0的对象池在有正在使用的Actor时不会被淘汰。
+	// Eviction priority when the Actors on standby of all pools exceed the global memory budget (Firefly.ObjectPool.DormantBudgetMB), pools with lower priority and least recently used are evicted first. Pools with a priority greater than 0 aren't evicted while they have Actors in use.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	int32 Priority = 0;
+
+	// 是否按变体索引待命Actor。启用后可以用ActorPool_SpawnActorOfVariant直接取出指定变体（如颜色、等级、装备）的待命Actor，没有匹配时取出重新配置代价最小的变体。
+	// Whether to index the Actors on standby by variant. When enabled, ActorPool_SpawnActorOfVariant takes out an Actor on standby of the given variant (such as a color, tier or loadout) directly, or the variant cheapest to reconfigure if none matches.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	bool bIndexVariants = false;
+
+	// 对象池统一检测的自动回收条件。
+	// Auto-release triggers evaluated centrally by the object pool.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FireflyObjectPool")
+	FFireflyActorPoolReleaseTriggers ReleaseTriggers;
+};
+
+/** 从对象池中取出并正在使用的Actor的记录 */
+/** Record of an Actor taken out from the object pool and in use */
+struct FIREFLYOBJECTPOOL_API FFireflyActiveActorRecord
+{
+	TObjectPtr<AActor> Actor;
+
+	// Actor被取出时的位置。
+	// Location of the Actor when it was taken out.
+	FVector SpawnLocation = FVector::ZeroVector;
+
+	// Actor被取出时是否有Owner。
+	// Whether the Actor had an Owner when it was taken out.
+	bool bHadOwner = false;
+
+	// 缓存的组件，避免每次检测回收条件时查找组件。
+	// Cached components so the release triggers don't search for them on every check.
+	TWeakObjectPtr<UProjectileMovementComponent> ProjectileMovement;
+
+	TWeakObjectPtr<UAudioComponent> Audio;
+
+	// 音频组件是否已经开始播放过，只有播放过又停止才算播放完毕。
+	// Whether the audio component has started playing, it only counts as finished once it played and stopped.
+	bool bAudioStarted = false;
+
+	// 生命周期计时器，Actor被回收或移出活跃集合时清除。
+	// Timer of the lifetime, cleared when the Actor is released or removed from the active set.
+	FTimerHandle LifetimeTimer;
+
+	// Actor被取出时的变体，放回时按该变体索引。
+	// Variant of the Actor when it was taken out, indexed by it when put back.
+	FName Variant = NAME_None;
+};
+
+/** 正在使用的Actor所在的对象池及其在活跃数组中的位置 */
+/** The pool an Actor in use belongs to and its position in the active array */
+struct FIREFLYOBJECTPOOL_API FFireflyActiveActorHandle
+{
+	// Actor所属的Actor类对象池，PoolID有效时不使用。
+	// Class-based pool the Actor belongs to, unused if PoolID is valid.
+	TSubclassOf<AActor> PoolClass;
+
+	// Actor所属的ActorID对象池。
+	// ID-based pool the Actor belongs to.
+	FName PoolID = NAME_None;
+
+	// Actor在对象池的活跃数组中的索引。
+	// Index of the Actor in the active array of the pool.
+	int32 Index = INDEX_NONE;
+};
+
+/** 排队等待生成的Actor生成请求 */
+/** Actor spawn request queued for instantiation */
+struct FIREFLYOBJECTPOOL_API FFireflyActorPoolSpawnRequest
+{
+	int32 RequestID = INDEX_NONE;
+
+	TSubclassOf<AActor> ActorClass;
+
+	FName ActorID = NAME_None;
+
+	FTransform Transform;
+
+	float Lifetime = -1.f;
+
+	TWeakObjectPtr<AActor> Owner;
+
+	TWeakObjectPtr<APawn> Instigator;
+
+	// 请求完成时调用，请求被取消或生成失败时参数为空。
+	// Called when the request completes, the parameter is null if the request was cancelled or the spawn failed.
+	TFunction<void(AActor*)> OnSpawned;
+};
+
+/** 对象池统一推进的抛射物运动学数据，按结构数组紧密排列，与对象池的活跃数组一一对应 */
+/** Projectile kinematics advanced by the pool in one batch, packed as a structure of arrays parallel to the active array of the pool */
+struct FIREFLYOBJECTPOOL_API FFireflyBatchedProjectiles
+{
+	TArray<double> PositionX;
+	TArray<double> PositionY;
+	TArray<double> PositionZ;
+
+	TArray<float> VelocityX;
+	TArray<float> VelocityY;
+	TArray<float> VelocityZ;
+
+	TArray<float> GravityZ;
+
+	// 该位置的Actor是否由对象池推进。
+	// Whether the Actor at this index is advanced by the pool.
+	TArray<uint8> bManaged;
+
+	// 该位置的Actor的朝向是否跟随速度。
+	// Whether the rotation of the Actor at this index follows its velocity.
+	TArray<uint8> bRotationFollowsVelocity;
+
+	// 开始统一推进之前Actor和抛射物组件的Tick是否启用，停止统一推进时还原。
+	// Whether the tick of the Actor and of the projectile component was enabled before batching started, restored when batching stops.
+	TArray<uint8> bActorTickWasEnabled;
+	TArray<uint8> bMovementTickWasEnabled;
+
+	int32 Num() const { return bManaged.Num(); }
+
+	void SetNum(int32 NewNum)
+	{
+		PositionX.SetNumZeroed(NewNum);
+		PositionY.SetNumZeroed(NewNum);
+		PositionZ.SetNumZeroed(NewNum);
+		VelocityX.SetNumZeroed(NewNum);
+		VelocityY.SetNumZeroed(NewNum);
+		VelocityZ.SetNumZeroed(NewNum);
+		GravityZ.SetNumZeroed(NewNum);
+		bManaged.SetNumZeroed(NewNum);
+		bRotationFollowsVelocity.SetNumZeroed(NewNum);
+		bActorTickWasEnabled.SetNumZeroed(NewNum);
+		bMovementTickWasEnabled.SetNumZeroed(NewNum);
+	}
+
+	void RemoveAtSwap(int32 Index)
+	{
+		PositionX.RemoveAtSwap(Index, 1, false);
+		PositionY.RemoveAtSwap(Index, 1, false);
+		PositionZ.RemoveAtSwap(Index, 1, false);
+		VelocityX.RemoveAtSwap(Index, 1, false);
+		VelocityY.RemoveAtSwap(Index, 1, false);
+		VelocityZ.RemoveAtSwap(Index, 1, false);
+		GravityZ.RemoveAtSwap(Index, 1, false);
+		bManaged.RemoveAtSwap(Index, 1, false);
+		bRotationFollowsVelocity.RemoveAtSwap(Index, 1, false);
+		bActorTickWasEnabled.RemoveAtSwap(Index, 1, false);
+		bMovementTickWasEnabled.RemoveAtSwap(Index, 1, false);
+	}
+};
+
+/** 每个对象池一个的Tick函数，统一推进该对象池中正在使用的抛射物 */
+/** One tick function per pool, advances the projectiles in use of that pool in one batch */
+USTRUCT()
+struct FIREFLYOBJECTPOOL_API FFireflyActorPoolTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	TSubclassOf<AActor> PoolClass;
+
+	FName PoolID = NAME_None;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread
+		, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	virtual FString DiagnosticMessage() override;
+
+	virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FFireflyActorPoolTickFunction> : public TStructOpsTypeTraitsBase2<FFireflyActorPoolTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/** Actor池的运行时数据 */
+/** Runtime data of an actor pool */
+struct FIREFLYOBJECTPOOL_API FFireflyActorPool
+{
+	// 在对象池中待命的Actor。
+	// Actors on standby in the pool.
+	TArray<TObjectPtr<AActor>> Actors;
+
+	// 对象池的配置。
+	// Configuration of the pool.
+	FFireflyActorPoolConfig Config;
+
+	// 采样得到的单个Actor（含组件）估算占用内存的字节数，小于0表示尚未采样。
+	// Sampled estimated memory in bytes of a single Actor (including its components), less than 0 means not sampled yet.
+	int64 SampledActorBytes = INDEX_NONE;
+
+	// 用于复制生成新Actor的模板实例，只执行过构造，注销了组件和Tick函数，不在关卡的Actor列表中，也从不在对象池中。
+	// Template instance new Actors are copied from, it has only run its construction, has its components and tick functions unregistered, isn't in the Actor list of the level and is never in the pool.
+	TObjectPtr<AActor> TemplateActor;
+
+	// 从对象池中取出并正在使用的Actor，紧密排列，移除时与末尾交换。
+	// Actors taken out from the pool and in use, densely packed and swap-removed.
+	TArray<FFireflyActiveActorRecord> ActiveActors;
+
+	// 对象池统一推进的抛射物运动学数据，仅在启用bBatchProjectileMovement时维护。
+	// Projectile kinematics advanced by the pool, only maintained if bBatchProjectileMovement is enabled.
+	FFireflyBatchedProjectiles BatchedProjectiles;
+
+	// 统一推进抛射物的Tick函数，首次有抛射物被对象池推进时注册。
+	// Tick function advancing the projectiles, registered when the pool first advances a projectile.
+	TUniquePtr<FFireflyActorPoolTickFunction> TickFunction;
+
+	// 渲染该对象池所有轻量实例的共享组件，由一个临时的宿主Actor持有。
+	// Shared component rendering all lightweight instances of the pool, owned by a transient host Actor.
+	TWeakObjectPtr<UInstancedStaticMeshComponent> LightweightComponent;
+
+	// 最近一次从该对象池取出或加入轻量实例的Actor类，用于只知道ActorID时为对象池生成新的Actor（提升轻量实例、后台补充）。
+	// Actor class last taken out from the pool or added as a lightweight instance, used to spawn new Actors for the pool when only the ActorID is known (promoting lightweight instances, background refill).
+	TSubclassOf<AActor> ActorClass;
+
+	// 每个轻量实例的ID和位置，与LightweightComponent中的实例一一对应，移除时与末尾交换。
+	// ID and location of every lightweight instance, parallel to the instances of LightweightComponent and swap-removed.
+	TArray<int32> LightweightIds;
+
+	TArray<FVector> LightweightLocations;
+
+	// 每秒取出Actor次数的指数移动平均。
+	// Exponential moving average of the Actors taken out per second.
+	float FetchRate = 0.f;
+
+	// 自上次更新FetchRate以来取出Actor的次数。
+	// Number of Actors taken out since FetchRate was last updated.
+	int32 PendingFetches = 0;
+
+	// 是否正在后台补充，达到目标数量后才停止。
+	// Whether the pool is being refilled in the background, stops only when the target number is reached.
+	bool bRefilling = false;
+
+	// 待命Actor组成的GC簇的簇根。
+	// Cluster root of the GC cluster formed by the Actors on standby.
+	TObjectPtr<UObject> ClusterRoot;
+
+	// 距离把待命Actor组成GC簇的剩余时间，待命Actor每次变化时重置。
+	// Remaining time until the Actors on standby are clustered, reset whenever they change.
+	float ClusterCountdown = 0.f;
+
+	// 从其他对象池借入和借出给其他对象池的Actor数量。
+	// Number of Actors borrowed from and lent to other pools.
+	int32 NumBorrowed = 0;
+
+	int32 NumLent = 0;
+
+	// 最近一次从对象池取出或放回Actor的帧号，用于全局内存预算的最久未使用淘汰。
+	// Frame number of the last time an Actor was taken out from or put back into the pool, used for the least-recently-used eviction of the global memory budget.
+	uint64 LastUsedFrame = 0;
+
+	// 与Actors一一对应的变体及其在VariantSlots变体下标列表中的位置，仅在启用bIndexVariants时维护。
+	// Variants parallel to Actors and their positions in the index lists of VariantSlots, only maintained if bIndexVariants is enabled.
+	TArray<FName> ActorVariants;
+
+	TArray<int32> VariantSlotPositions;
+
+	// 每个变体的待命Actor在Actors中的下标。
+	// Indices in Actors of the Actors on standby of every variant.
+	TMap<FName, TArray<int32>> VariantSlots;
+
+	// 把Actor放进对象池待命，启用bIndexVariants时同时按变体索引。
+	// Put the Actor on standby in the pool, also indexed by variant if bIndexVariants is enabled.
+	void PushActor(AActor* Actor, FName Variant = NAME_None);
+
+	// 取出最后放入的待命Actor，对象池为空时返回nullptr。OutVariant不为空时返回取出的Actor的变体。
+	// Take out the last Actor put on standby, returns nullptr if the pool is empty. Returns the variant of the taken Actor through OutVariant if it isn't null.
+	AActor* PopActor(FName* OutVariant = nullptr);
+
+	// 取出指定变体的待命Actor，没有匹配时取出重新配置代价最小的变体，OutVariant返回取出的Actor的变体。
+	// Take out an Actor on standby of the variant, or of the variant cheapest to reconfigure if none matches, OutVariant returns the variant of the taken Actor.
+	AActor* PopActorOfVariant(FName Variant, FName& OutVariant);
+
+	// 移除指定下标的待命Actor，最后一个待命Actor会被交换到该位置。OutVariant不为空时返回移除的Actor的变体。
+	// Remove the Actor on standby at the index, the last Actor on standby is swapped into its place. Returns the variant of the removed Actor through OutVariant if it isn't null.
+	AActor* RemoveActorAt(int32 Index, FName* OutVariant = nullptr);
+
+	// 按当前配置重建变体索引，变体未知的待命Actor记为NAME_None。
+	// Rebuild the variant index from the current configuration, Actors on standby of unknown variant are recorded as NAME_None.
+	void RebuildVariantIndex();
+
+	// 把Actor从一个变体重新配置为另一个变体的估算代价。同名仅数字后缀不同的变体（如Tier_1和Tier_3）代价为数字之差，其他不同的变体需要完全重新配置。
+	// Estimated cost of reconfiguring an Actor from one variant to another. Variants differing only by the number suffix (such as Tier_1 and Tier_3) cost the difference of the numbers, other different variants need a full reconfiguration.
+	static int32 GetVariantDistance(FName From, FName To);
+
+	// 对象池中待命Actor估算占用内存的字节数。
+	// Estimated memory in bytes of Actors on standby in the pool.
+	int64 GetEstimatedBytes() const { return SampledActorBytes > 0 ? SampledActorBytes * Actors.Num() : 0; }
+
+	// 根据配置计算对象池的容量，返回MAX_int32表示不限制。
+	// Compute the capacity of the pool from its configuration, returns MAX_int32 if unlimited.
+	int32 GetCapacity() const
+	{
+		int32 Capacity = Config.MaxCount > 0 ? Config.MaxCount : MAX_int32;
+		if (Config.MaxMegabytes > 0.f && SampledActorBytes > 0)
+		{
+			const int64 CapacityByMemory = static_cast<int64>(Config.MaxMegabytes * 1024.f * 1024.f) / SampledActorBytes;
+			Capacity = FMath::Min<int64>(Capacity, CapacityByMemory);
+		}
+
+		return Capacity;
+	}
+};
+
+/** Widget池的运行时数据 */
+/** Runtime data of a widget pool */
+struct FIREFLYOBJECTPOOL_API FFireflyWidgetPool
+{
+	// 在对象池中待命的Widget。
+	// Widgets on standby in the pool.
+	TArray<TObjectPtr<UUserWidget>> Widgets;
+
+	// 与Widgets一一对应的底层Slate控件，对象池持有它们使控件树在复用之间不会被销毁和重建。
+	// Underlying Slate widgets parallel to Widgets, the pool holds them so the widget trees aren't destroyed and rebuilt between reuses.
+	TArray<TSharedPtr<SWidget>> SlateWidgets;
+
+	// 对象池中待命Widget的最大数量，小于等于0表示不限制。
+	// Max number of Widgets on standby in the pool, less than or equal to 0 means unlimited.
+	int32 MaxCount = 0;
+
+	int32 GetCapacity() const { return MaxCount > 0 ? MaxCount : MAX_int32; }
+};
@@ -3,17 +3,35 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "Engine/LatentActionManager.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "FireflyPoolingActorInterface.h"
+#include "FireflyObjectPoolTypes.h"
+#include "FireflyPoolingTraits.h"
 #include "FireflyObjectPoolWorldSubsystem.generated.h"
 
+class AFireflyActorPoolStock;
+class APlayerController;
+struct FActorSpawnParameters;
+class FScopedMovementUpdate;
+class UFXSystemAsset;
+class UFXSystemComponent;
+class UNiagaraComponent;
+class UParticleSystemComponent;
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FFireflyActorPoolSpawnDelegate, AActor*, SpawnedActor);
+
 /** 基于世界的对象池子系统 */
 /** World based object pool subsystem */
 UCLASS()
-class FIREFLYOBJECTPOOL_API UFireflyObjectPoolWorldSubsystem : public UWorldSubsystem
+class FIREFLYOBJECTPOOL_API UFireflyObjectPoolWorldSubsystem : public UTickableWorldSubsystem
 {
 	GENERATED_BODY()
 
+	friend struct FFireflyActorPoolTickFunction;
+	friend class FFireflyObjectPoolReferenceCollector;
+
 #pragma region WorldSubsystem
 
 public:
@@ -21,6 +39,12 @@ public:
 
 	virtual void Deinitialize() override;
 
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
 #pragma endregion
 
 
@@ -45,6 +69,82 @@ public:
 #pragma endregion
 
 
+#pragma region ActorPool_SeamlessTravel
+
+public:
+	// 把启用了bKeepAcrossSeamlessTravel的对象池中属于指定世界的待命Actor和模板实例加入ActorList，应在GameMode的GetSeamlessTravelActorList中调用。
+	// Add the Actors on standby and template instances belonging to the specified world of the pools with bKeepAcrossSeamlessTravel enabled to ActorList, should be called in GetSeamlessTravelActorList of the GameMode.
+	static void ActorPool_GetSeamlessTravelActors(const UObject* WorldContextObject, TArray<AActor*>& ActorList);
+
+	// 生成指定类以及指定ID的Actor放进Actor池中，直到待命数量达到TargetCount，只会生成差额。
+	// Spawn Actors of a specified class and a specified ID into the Actor pool until the number on standby reaches TargetCount, only the difference is spawned.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", meta = (WorldContext = "WorldContextObject"))
+	static void ActorPool_WarmUpToCount(const UObject* WorldContextObject, TSubclassOf<AActor> ActorClass, FName ActorID
+		, const FTransform& Transform, int32 TargetCount = 16);
+
+	// 把预先放置在关卡中的待命Actor直接放进对应的对象池，不生成任何Actor。超出对象池容量的Actor会被销毁。
+	// Put the Actors on standby pre-placed in the level directly into their pools without spawning any Actor. Actors beyond the pool capacity are destroyed.
+	static void ActorPool_AdoptBakedStock(AFireflyActorPoolStock* Stock);
+
+protected:
+	// 无缝切换地图时清理对象池，保留启用了bKeepAcrossSeamlessTravel的对象池的待命Actor，清理其余所有对象池。
+	// Clear the pools on seamless travel, keeping the Actors on standby of the pools with bKeepAcrossSeamlessTravel enabled and clearing all other pools.
+	static void ActorPool_ClearForSeamlessTravel();
+
+	// 接管随无缝切换地图来到本世界的待命Actor，销毁没有被带过来的Actor。只在无缝切换地图后执行一次。
+	// Adopt the Actors on standby that came to this world with seamless travel, destroying the ones that weren't carried over. Only runs once after seamless travel.
+	void AdoptTravelledPools();
+
+	// 是否有对象池为无缝切换地图保留了待命Actor，等待目标世界接管。
+	// Whether pools kept their Actors on standby for seamless travel and are waiting for the destination world to adopt them.
+	static bool bPendingTravelAdoption;
+
+#pragma endregion
+
+
+#pragma region ActorPool_Config
+
+public:
+	// 设置指定类的Actor池的配置，如果对象池不存在则会创建。
+	// Set the configuration of the actor pool of specified class, the pool will be created if it doesn't exist.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ActorPool_SetConfigOfClass(TSubclassOf<AActor> ActorClass, const FFireflyActorPoolConfig& Config);
+
+	// 设置指定ID的Actor池的配置，如果对象池不存在则会创建。
+	// Set the configuration of the actor pool of specified ID, the pool will be created if it doesn't exist.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ActorPool_SetConfigOfID(FName ActorID, const FFireflyActorPoolConfig& Config);
+
+#pragma endregion
+
+
+#pragma region ActorPool_Trim
+
+public:
+	// 销毁指定类的Actor池中多余的待命Actor，使其数量不超过KeepCount且估算内存不超过KeepMegabytes，参数小于0表示不限制该项。
+	// Destroy surplus standby Actors in the actor pool of specified class so that the count doesn't exceed KeepCount and the estimated memory doesn't exceed KeepMegabytes, a negative parameter means no limit on that item.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ActorPool_TrimByClass(TSubclassOf<AActor> ActorClass, int32 KeepCount = -1, float KeepMegabytes = -1.f);
+
+	// 销毁指定ID的Actor池中多余的待命Actor，使其数量不超过KeepCount且估算内存不超过KeepMegabytes，参数小于0表示不限制该项。
+	// Destroy surplus standby Actors in the actor pool of specified ID so that the count doesn't exceed KeepCount and the estimated memory doesn't exceed KeepMegabytes, a negative parameter means no limit on that item.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ActorPool_TrimByID(FName ActorID, int32 KeepCount = -1, float KeepMegabytes = -1.f);
+
+protected:
+	static void TrimPool_Internal(FFireflyActorPool& Pool, int32 KeepCount);
+
+	// 所有对象池待命Actor的估算内存总和（字节）。
+	// Total estimated memory in bytes of the Actors on standby of all pools.
+	static int64 GetTotalDormantBytes();
+
+	// 所有对象池的待命Actor超出全局内存预算时，在每帧的淘汰预算内从优先级最低、最久未使用的对象池开始销毁待命Actor。
+	// When the Actors on standby of all pools exceed the global memory budget, destroy Actors on standby within the per-frame eviction budget, starting from the pools with the lowest priority and least recently used.
+	static void EvictOverBudgetPools();
+
+#pragma endregion
+
+
 #pragma region ActorPool_Fetch
 
 public:
@@ -72,7 +172,46 @@ public:
 protected:
 	AActor* SpawnActor_Internal(TSubclassOf<AActor> ActorClass, FName ActorID, const FTransform& Transform
 		, float Lifetime = -1.f, AActor* Owner = nullptr, APawn* Instigator = nullptr
-		, const ESpawnActorCollisionHandlingMethod CollisionHandling = ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		, const ESpawnActorCollisionHandlingMethod CollisionHandling = ESpawnActorCollisionHandlingMethod::AlwaysSpawn
+		, bool bSweep = false, FName Variant = NAME_None, FName* OutPreviousVariant = nullptr);
+
+	// 从启用了bIndexVariants的对象池中取出指定变体的待命Actor，没有匹配时取出重新配置代价最小的变体，OutPreviousVariant返回取出的Actor原来的变体。对象池未启用变体索引时等同于ActorPool_FetchActor。
+	// Take an Actor on standby of the variant out of a pool with bIndexVariants enabled, or of the variant cheapest to reconfigure if none matches, OutPreviousVariant returns the former variant of the taken Actor. Equivalent to ActorPool_FetchActor if the pool doesn't index variants.
+	static AActor* FetchActorOfVariant_Internal(TSubclassOf<AActor> ActorClass, FName ActorID, FName Variant, FName& OutPreviousVariant);
+
+	// 处于FFireflyScopedActorPoolBatch作用域内时，先记录取出的Actor，把Activation推迟到作用域提交变换之后执行，Actor在此之前被回收或销毁时不再执行。返回是否已推迟。
+	// Within a FFireflyScopedActorPoolBatch scope, track the fetched Actor now and defer Activation until the scope has committed the transforms, it's skipped if the Actor is released or destroyed before then. Returns whether it was deferred.
+	static bool DeferFetchedActivation(AActor* Actor, AActor* Owner, TFunction<void(AActor*, AActor*)> Activation);
+
+	// 把从对象池取出的Actor传送到指定变换，默认不进行扫掠。如果处于FFireflyScopedActorPoolBatch作用域内，重叠检测和子组件变换更新会推迟到作用域结束。
+	// Teleport the Actor taken out from the pool to the transform, without sweeping by default. Within a FFireflyScopedActorPoolBatch scope, overlap and child transform updates are deferred until the scope ends.
+	static void TeleportFetchedActor(AActor* Actor, const FTransform& Transform, bool bSweep);
+
+	// 为对象池生成一个新的Actor，如果对应的对象池启用了模板生成，则从其模板实例复制生成。
+	// Spawn a new Actor for the pool, copying it from the template instance if the corresponding pool spawns from template.
+	static AActor* SpawnNewActor_Internal(UWorld* World, TSubclassOf<AActor> ActorClass, FName ActorID
+		, const FTransform& Transform, FActorSpawnParameters& SpawnParameters);
+
+	static AActor* SpawnNewActor_Internal(UWorld* World, TSubclassOf<AActor> ActorClass, FName ActorID
+		, const FTransform& Transform, AActor* Owner, APawn* Instigator, ESpawnActorCollisionHandlingMethod CollisionHandling);
+
+	// 如果生命周期大于0，在生命周期结束后把Actor回收到对象池。
+	// Release the Actor back into the pool when its lifetime runs out, if the lifetime is greater than 0.
+	static void SetActorLifetime_Internal(AActor* Actor, float Lifetime);
+
+	// 获取对象池的模板实例，如果尚未创建则生成一个。模板实例只执行构造，不执行组件初始化和BeginPlay，注销了组件和Tick函数，并且不在关卡的Actor列表中。
+	// Get the template instance of the pool, spawn one if it doesn't exist yet. The template only runs its construction, never component initialization or BeginPlay, has its components and tick functions unregistered and isn't in the Actor list of the level.
+	static AActor* GetOrCreateTemplateActor(UWorld* World, FFireflyActorPool& Pool, TSubclassOf<AActor> ActorClass, FName ActorID);
+
+	// 复制模板实例生成一个新Actor，不执行SCS和构造脚本，只注册组件并执行PostActorCreated、组件初始化和BeginPlay。
+	// UWorld的生成广播（OnActorSpawned）是私有的，不经过SpawnActor就无法广播，所以复制得到的Actor不会通知生成监听者，需要感知它们的逻辑应使用PoolingBeginPlay。
+	// Spawn a new Actor by duplicating the template instance without running the SCS or the construction script, only registering the components and running PostActorCreated, component initialization and BeginPlay.
+	// The spawn broadcast of UWorld (OnActorSpawned) is private and can't be raised without SpawnActor, so duplicated Actors don't notify spawn listeners, logic that needs to see them should use PoolingBeginPlay.
+	static AActor* DuplicateTemplateActor(UWorld* World, AActor* Template, const FTransform& Transform, const FActorSpawnParameters& SpawnParameters);
+
+	// 如果ActorID对象池允许借用，则从同类且有富余的其他ActorID对象池中取出一个待命Actor，记录转移并以原变体记录到借用方的对象池中，ActorID的修改由调用者完成。
+	// If the ID-based pool allows borrowing, take an Actor on standby out of another ID-based pool of the same class with surplus, record the transfer and track it in the borrowing pool with its variant, the caller re-tags the ActorID.
+	static AActor* BorrowActor_Internal(TSubclassOf<AActor> ActorClass, FName ActorID);
 
 public:
 	// 从ActorPool生成执行指定Actor类的实例，但不会自动运行其构造脚本及其ActorPool初始化。
@@ -81,7 +220,8 @@ public:
 		, UnsafeDuringActorConstruction = "true", BlueprintInternalUseOnly = "true"))
 	static AActor* ActorPool_BeginDeferredActorSpawn(const UObject* WorldContext
 		, TSubclassOf<AActor> ActorClass, FName ActorID, const FTransform& SpawnTransform, AActor* Owner = nullptr
-		, ESpawnActorCollisionHandlingMethod CollisionHandling = ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		, ESpawnActorCollisionHandlingMethod CollisionHandling = ESpawnActorCollisionHandlingMethod::AlwaysSpawn
+		, bool bSweep = false);
 
 	// 完成从ActorPool生成一个Actor实例，并且会执行Actor的构造脚本和ActorPool初始化。
 	// 'Finish' spawning an actor from ActorPool.  This will run the construction script and the ActorPool initialization.
@@ -92,7 +232,72 @@ public:
 	template<typename T>
 	T* ActorPool_SpawnActor(TSubclassOf<T> ActorClass, FName ActorID, const FTransform& Transform
 		, float Lifetime = -1.f, AActor* Owner = nullptr, APawn* Instigator = nullptr
-		, const ESpawnActorCollisionHandlingMethod CollisionHandling = ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		, const ESpawnActorCollisionHandlingMethod CollisionHandling = ESpawnActorCollisionHandlingMethod::AlwaysSpawn
+		, bool bSweep = false);
+
+	// 从ActorPool批量生成指定Actor类的实例，每个变换生成一个。所有取出Actor的重叠检测和子组件变换更新会在整批生成完成后统一提交。
+	// Spawn a batch of instances of the specified actor class from ActorPool, one per transform. Overlap and child transform updates of all fetched Actors are committed once after the whole batch.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "ActorClass"))
+	static TArray<AActor*> ActorPool_SpawnActorsBatched(const UObject* WorldContextObject, TSubclassOf<AActor> ActorClass
+		, FName ActorID, const TArray<FTransform>& Transforms, float Lifetime = -1.f, AActor* Owner = nullptr
+		, APawn* Instigator = nullptr);
+
+	// 从ActorPool生成指定变体（如颜色、等级、装备）的Actor实例。对象池启用了bIndexVariants时优先取出同一变体的待命Actor，没有匹配时取出重新配置代价最小的变体。PreviousVariant返回Actor原来的变体，与Variant不同时（包括新生成的Actor返回的NAME_None）调用者需要把Actor重新配置为Variant。Actor回收后会按Variant放回对象池。
+	// Spawn an instance of the specified variant (such as a color, tier or loadout) from ActorPool. If the pool has bIndexVariants enabled, an Actor on standby of the same variant is taken first, or of the variant cheapest to reconfigure if none matches. PreviousVariant returns the former variant of the Actor, the caller needs to reconfigure the Actor to Variant when they differ (including NAME_None returned for newly spawned Actors). The Actor is put back under Variant when released.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "ActorClass"))
+	static AActor* ActorPool_SpawnActorOfVariant(const UObject* WorldContextObject, TSubclassOf<AActor> ActorClass, FName ActorID
+		, FName Variant, const FTransform& Transform, FName& PreviousVariant, float Lifetime = -1.f, AActor* Owner = nullptr
+		, APawn* Instigator = nullptr);
+
+#pragma endregion
+
+
+#pragma region ActorPool_SpawnQueue
+
+public:
+	// 异步从ActorPool生成指定Actor类的实例。对象池中有待命Actor时立即生成并调用OnSpawned，否则把请求加入队列，在每帧的生成数量上限和时间预算内生成。返回请求ID，可用于取消请求。
+	// Spawn an instance of the specified actor class from ActorPool asynchronously. If the pool has Actors on standby it's spawned immediately and OnSpawned is called, otherwise the request is queued and spawned within the per-frame count cap and time budget. Return the request ID, which can be used to cancel the request.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (DisplayName = "Actor Pool Spawn Actor Async", WorldContext = "WorldContextObject"))
+	static int32 K2_ActorPool_SpawnActorAsync(const UObject* WorldContextObject, TSubclassOf<AActor> ActorClass, FName ActorID
+		, const FTransform& Transform, FFireflyActorPoolSpawnDelegate OnSpawned, float Lifetime = -1.f, AActor* Owner = nullptr
+		, APawn* Instigator = nullptr);
+
+	static int32 ActorPool_SpawnActorAsync(const UObject* WorldContextObject, TSubclassOf<AActor> ActorClass, FName ActorID
+		, const FTransform& Transform, TFunction<void(AActor*)> OnSpawned, float Lifetime = -1.f, AActor* Owner = nullptr
+		, APawn* Instigator = nullptr);
+
+	// 异步从ActorPool生成指定Actor类的实例，生成完成后继续执行。请求被取消或生成失败时SpawnedActor为空。
+	// Spawn an instance of the specified actor class from ActorPool asynchronously and resume once spawned. SpawnedActor is null if the request was cancelled or the spawn failed.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject", Latent, LatentInfo = "LatentInfo"
+		, DeterminesOutputType = "ActorClass", DynamicOutputParam = "SpawnedActor"))
+	static void ActorPool_SpawnActorLatent(const UObject* WorldContextObject, FLatentActionInfo LatentInfo, TSubclassOf<AActor> ActorClass
+		, FName ActorID, const FTransform& Transform, float Lifetime, AActor* Owner, APawn* Instigator, AActor*& SpawnedActor);
+
+	// 取消一个排队中的生成请求，它的OnSpawned会以空参数调用。返回请求是否仍在队列中。
+	// Cancel a queued spawn request, its OnSpawned is called with null. Return whether the request was still queued.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static bool ActorPool_CancelSpawnRequest(const UObject* WorldContextObject, int32 RequestID);
+
+	// 取消所有排队中的生成请求。
+	// Cancel all queued spawn requests.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static void ActorPool_CancelAllSpawnRequests(const UObject* WorldContextObject);
+
+	// 返回排队中的生成请求数量。
+	// Return the number of queued spawn requests.
+	UFUNCTION(BlueprintPure, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static int32 ActorPool_GetPendingSpawnRequestNum(const UObject* WorldContextObject);
+
+protected:
+	// 在每帧的生成数量上限和时间预算内处理生成请求队列。
+	// Process the spawn request queue within the per-frame count cap and time budget.
+	void ProcessSpawnRequests();
+
+	// 排队中的生成请求，按请求顺序生成。
+	// Queued spawn requests, spawned in request order.
+	TArray<FFireflyActorPoolSpawnRequest> PendingSpawnRequests;
+
+	int32 NextSpawnRequestID = 0;
 
 #pragma endregion
 
@@ -105,6 +310,61 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (DisplayName = "Actor Pool Release Actor"))
 	static void ActorPool_ReleaseActor(AActor* Actor);
 
+	// 批量回收Actor，按所属对象池分组后每个对象池只查找一次并一次性放回。bWithinFrameBudget为true时会分摊到多帧中回收，使每帧的回收耗时不超过预算。
+	// Release a batch of Actors, grouped by their pools so each pool is looked up once and refilled in a single append. If bWithinFrameBudget is true, the releases are spread across frames so each frame stays under the release budget.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ActorPool_ReleaseActors(const TArray<AActor*>& Actors, bool bWithinFrameBudget = false);
+
+	// 带类型的回收，如果T特化了TFireflyPoolingTraits则直接内联调用其特性，否则等同于ActorPool_ReleaseActor。
+	// Typed release, inlines the traits directly if TFireflyPoolingTraits is specialized for T, otherwise equivalent to ActorPool_ReleaseActor.
+	template<typename T>
+	static void ActorPool_ReleaseActor(T* Actor);
+
+protected:
+	// 停止等待Actor的特效播放完毕并把它移出活跃集合，必须在执行PoolingEndPlay之前调用。返回Actor被取出时的变体。
+	// Stop waiting for the FX of the Actor to finish and remove it from the active set, must be called before PoolingEndPlay is executed. Return the variant of the Actor when it was taken out.
+	static FName DetachReleasedActor_Internal(AActor* Actor);
+
+	// 把已执行过PoolingEndPlay的Actor按变体放回ActorID对应的对象池，对象池已满时销毁它。
+	// Put the Actor that has executed PoolingEndPlay back into the pool of the ActorID under its variant, destroy it when the pool is full.
+	static void ReturnActorToPool_Internal(AActor* Actor, FName ActorID, FName Variant = NAME_None);
+
+	// 把同一对象池的一组已执行过PoolingEndPlay的Actor及其变体一次性放回对象池，超出容量的部分被销毁。
+	// Put a group of Actors of the same pool that have executed PoolingEndPlay back into the pool at once with their variants, the part beyond the capacity is destroyed.
+	static void ReturnActorsToPool_Internal(FFireflyActorPool& Pool, TArray<AActor*>& Actors, const TArray<FName>& Variants);
+
+#pragma endregion
+
+
+#pragma region ActorPool_NativeTraits
+
+public:
+	// 注册原生类的编译期池化特性，使蓝图和通用流程（回收触发器、召回等）对该类及其子类也调用特性而不是IFireflyPoolingActorInterface。带类型的模板函数首次使用时会自动注册。
+	// Register the compile-time pooling traits of a native class, so that Blueprint and the generic paths (release triggers, recall, etc.) also call the traits instead of IFireflyPoolingActorInterface for the class and its subclasses. The typed templates register automatically on first use.
+	template<typename T>
+	static void ActorPool_RegisterNativeTraits();
+
+protected:
+	// 查找Actor类或其最近的父类注册的原生池化特性。
+	// Find the native pooling traits registered for the Actor class or its nearest super class.
+	static const FFireflyPoolingNativeHooks* FindNativeHooks(const UClass* ActorClass);
+
+	// 以下函数优先调用已注册的原生池化特性，否则调用IFireflyPoolingActorInterface。
+	// The following functions call the registered native pooling traits first, otherwise IFireflyPoolingActorInterface.
+	static void Pooling_BeginPlay(AActor* Actor);
+	static void Pooling_EndPlay(AActor* Actor);
+	static void Pooling_WarmUp(AActor* Actor);
+	static FName Pooling_GetActorID(const AActor* Actor);
+	static void Pooling_SetActorID(AActor* Actor, FName ActorID);
+
+	// 已注册原生池化特性的Actor类。
+	// Actor classes with registered native pooling traits.
+	static TMap<TObjectKey<UClass>, const FFireflyPoolingNativeHooks*> NativeHooksOfClass;
+
+	// 每个查找过的Actor类沿继承链解析出的原生池化特性，值为空表示该类没有特性。注册新的特性时清空。
+	// Native pooling traits resolved along the inheritance chain for every looked up Actor class, a null value means the class has none. Emptied when new traits are registered.
+	static TMap<TObjectKey<UClass>, const FFireflyPoolingNativeHooks*> ResolvedNativeHooksOfClass;
+
 #pragma endregion
 
 
@@ -116,10 +376,378 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", meta = (WorldContext = "WorldContextObject"))
 	static void ActorPool_WarmUp(const UObject* WorldContextObject, TSubclassOf<AActor> ActorClass, FName ActorID
 		, const FTransform& Transform, AActor* Owner = nullptr, APawn* Instigator = nullptr, int32 Count = 16);
+
+protected:
+	// 为对象池生成一个新的Actor并使其进入待命状态，返回是否成功放入对象池。
+	// Spawn a new Actor for the pool and put it on standby, return whether it was put into the pool.
+	static bool WarmUpActor_Internal(UWorld* World, FFireflyActorPool& Pool, TSubclassOf<AActor> ActorClass, FName ActorID
+		, const FTransform& Transform, FActorSpawnParameters& SpawnParameters);
+
+	// 更新所有对象池的需求预测，并在每帧的补充预算内补充预测会低于低水位的对象池。
+	// Update the demand prediction of all pools and refill the pools predicted to drop below their low watermark within the per-frame refill budget.
+	void RefillPools(float DeltaTime);
+
+	// 对象池所属的世界，即池中任意Actor或模板Actor所在的世界，对象池为空时返回空。
+	// World the pool belongs to, i.e. the world of any Actor or the template Actor in the pool, returns null if the pool is empty.
+	static UWorld* GetPoolWorld(const FFireflyActorPool& Pool);
+
+	// 最近一次维护静态对象池的帧号。对象池由所有世界共享，每帧只由第一个Tick的世界子系统维护一次。
+	// Frame number of the last maintenance of the static pools. The pools are shared by all worlds, so only the first world subsystem ticking each frame maintains them.
+	static uint64 LastPoolMaintenanceFrame;
 	
 #pragma endregion
 
 
+#pragma region ComponentPool
+
+public:
+	// 生成特定数量的指定类的Component并放进Component池中待命。
+	// Create a specific number of Components of a specified class and place them in the Component pool on standby.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static void ComponentPool_WarmUp(const UObject* WorldContextObject, TSubclassOf<UActorComponent> ComponentClass, int32 Count = 16);
+
+	// 从Component池里取出一个指定类的Component，把它注册到宿主Actor上（如果是SceneComponent则附加到AttachParent，默认为宿主的根组件）并进行初始化。如果Component池中没有可用的Component，则会创建一个新的。
+	// Take a Component of a specified class from the Component pool, register it on the host Actor (attach it to AttachParent if it's a SceneComponent, which defaults to the root component of the host) and initialize it. A new Component will be created if there is no available Component in the pool.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (DisplayName = "Component Pool Spawn Component", WorldContext = "WorldContextObject", DeterminesOutputType = "ComponentClass"))
+	static UActorComponent* K2_ComponentPool_SpawnComponent(const UObject* WorldContextObject, TSubclassOf<UActorComponent> ComponentClass
+		, AActor* Host, USceneComponent* AttachParent, FName SocketName, const FTransform& RelativeTransform);
+
+	template<typename T>
+	static T* ComponentPool_SpawnComponent(const UObject* WorldContextObject, TSubclassOf<T> ComponentClass
+		, AActor* Host, USceneComponent* AttachParent = nullptr, FName SocketName = NAME_None
+		, const FTransform& RelativeTransform = FTransform::Identity);
+
+	// 把Component从宿主Actor上分离并注销，回收到Component池里进入冻结状态。
+	// Detach and unregister the Component from its host Actor, recycle it back into the Component pool in a frozen state.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (DisplayName = "Component Pool Release Component"))
+	static void ComponentPool_ReleaseComponent(UActorComponent* Component);
+
+	// 清理所有Component池。
+	// Clear all Component pools.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ComponentPool_ClearAll();
+
+	// 清理指定类的Component池。
+	// Clear the Component pool of specified class.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ComponentPool_ClearByClass(TSubclassOf<UActorComponent> ComponentClass);
+
+	// 返回在对象池中待命的指定类的Component的数量，如果不存在指定类的Component的对象池，则返回-1。
+	// Return the number of Components of a specified class on standby in the object pool. If the object pool for the specified class of Components does not exist, return -1.
+	UFUNCTION(BlueprintPure, Category = "FireflyObjectPool")
+	static int32 ComponentPool_DebugComponentNumberOfClass(TSubclassOf<UActorComponent> ComponentClass);
+
+protected:
+	// 从Component池里取出一个指定类的Component并交给宿主Actor持有，宿主为空时由世界持有。
+	// Take a Component of a specified class from the Component pool and hand it to the host Actor, or to the world if the host is null.
+	static UActorComponent* AcquireComponent_Internal(UWorld* World, TSubclassOf<UActorComponent> ComponentClass, AActor* Host);
+
+	// 附加、注册并初始化取出的Component，AttachParent为空时Transform为世界变换。
+	// Attach, register and initialize the taken Component, Transform is in world space if AttachParent is null.
+	static void ActivateComponent_Internal(UWorld* World, UActorComponent* Component
+		, USceneComponent* AttachParent, FName SocketName, const FTransform& Transform);
+
+#pragma endregion
+
+
+#pragma region WidgetPool
+
+public:
+	// 创建特定数量的指定类的Widget并放进Widget池中待命，会预先构建它们的Slate控件树。
+	// Create a specific number of Widgets of a specified class and place them in the Widget pool on standby, their Slate widget trees are built in advance.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static void WidgetPool_WarmUp(const UObject* WorldContextObject, TSubclassOf<UUserWidget> WidgetClass
+		, APlayerController* OwningPlayer = nullptr, int32 Count = 16);
+
+	// 从Widget池里取出一个指定类的Widget并激活，没有可用的Widget时会创建一个新的。取出的Widget不会自动添加到视口或父控件中。
+	// Take a Widget of a specified class from the Widget pool and activate it, a new one is created if there is no available Widget. The Widget isn't added to the viewport or a parent automatically.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (DisplayName = "Widget Pool Fetch Widget", WorldContext = "WorldContextObject", DeterminesOutputType = "WidgetClass"))
+	static UUserWidget* K2_WidgetPool_FetchWidget(const UObject* WorldContextObject, TSubclassOf<UUserWidget> WidgetClass
+		, APlayerController* OwningPlayer = nullptr);
+
+	template<typename T>
+	static T* WidgetPool_FetchWidget(const UObject* WorldContextObject, TSubclassOf<T> WidgetClass, APlayerController* OwningPlayer = nullptr);
+
+	// 把Widget从父控件或视口中移除并回收到Widget池里，Widget池已满时Widget会被丢弃。
+	// Remove the Widget from its parent or the viewport and recycle it back into the Widget pool, the Widget is dropped if the pool is full.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void WidgetPool_ReleaseWidget(UUserWidget* Widget);
+
+	// 设置指定类的Widget池中待命Widget的最大数量，小于等于0表示不限制，多余的Widget会被丢弃。
+	// Set the max number of Widgets on standby in the Widget pool of specified class, less than or equal to 0 means unlimited, surplus Widgets are dropped.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void WidgetPool_SetMaxCountOfClass(TSubclassOf<UUserWidget> WidgetClass, int32 MaxCount);
+
+	// 清理所有Widget池。
+	// Clear all Widget pools.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void WidgetPool_ClearAll();
+
+	// 清理指定类的Widget池。
+	// Clear the Widget pool of specified class.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void WidgetPool_ClearByClass(TSubclassOf<UUserWidget> WidgetClass);
+
+	// 返回在对象池中待命的指定类的Widget的数量，如果不存在指定类的Widget的对象池，则返回-1。
+	// Return the number of Widgets of a specified class on standby in the object pool. If the object pool for the specified class of Widgets does not exist, return -1.
+	UFUNCTION(BlueprintPure, Category = "FireflyObjectPool")
+	static int32 WidgetPool_DebugWidgetNumberOfClass(TSubclassOf<UUserWidget> WidgetClass);
+
+protected:
+	// 创建一个新的Widget并构建其Slate控件树，控件树由OutSlateWidget持有。
+	// Create a new Widget and build its Slate widget tree, which is held by OutSlateWidget.
+	static UUserWidget* CreateWidget_Internal(UWorld* World, TSubclassOf<UUserWidget> WidgetClass, APlayerController* OwningPlayer
+		, TSharedPtr<SWidget>& OutSlateWidget);
+
+	static TMap<TSubclassOf<UUserWidget>, FFireflyWidgetPool> WidgetPoolOfClass;
+
+#pragma endregion
+
+
+#pragma region FXPool
+
+public:
+	// 从Actor池生成一个特效Actor，当它所有正在播放的Niagara和Cascade特效播放完毕时自动回收到Actor池。循环特效不会播放完毕，Actor有循环特效时改为在Lifetime结束后回收，Lifetime小于等于0时需要调用者自行回收。
+	// Spawn an FX Actor from the Actor pool, it returns to the Actor pool automatically once all its playing Niagara and Cascade effects have finished. Looping effects never finish, if the Actor has any it is released after Lifetime instead, and must be released by the caller if Lifetime is less than or equal to 0.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "ActorClass"))
+	static AActor* ActorPool_SpawnFXActor(const UObject* WorldContextObject, TSubclassOf<AActor> ActorClass, FName ActorID
+		, const FTransform& Transform, AActor* Owner = nullptr, APawn* Instigator = nullptr, float Lifetime = -1.f);
+
+	// 从Component池在指定位置播放一个Niagara或Cascade特效，特效播放完毕时组件自动回收到Component池。循环特效不会播放完毕，不会被播放并返回空。
+	// Play a Niagara or Cascade effect at the specified location from the Component pool, the component returns to the Component pool automatically once the effect has finished. Looping effects never finish, they aren't played and null is returned.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static UFXSystemComponent* FXPool_SpawnSystemAtLocation(const UObject* WorldContextObject, UFXSystemAsset* SystemTemplate
+		, FVector Location, FRotator Rotation, FVector Scale = FVector(1.f));
+
+	// 从Component池播放一个附加到指定组件上的Niagara或Cascade特效，特效播放完毕时组件自动回收到Component池。循环特效不会播放完毕，不会被播放并返回空。
+	// Play a Niagara or Cascade effect attached to the specified component from the Component pool, the component returns to the Component pool automatically once the effect has finished. Looping effects never finish, they aren't played and null is returned.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static UFXSystemComponent* FXPool_SpawnSystemAttached(const UObject* WorldContextObject, UFXSystemAsset* SystemTemplate
+		, USceneComponent* AttachToComponent, FName SocketName, FVector Location, FRotator Rotation);
+
+protected:
+	static UFXSystemComponent* SpawnSystem_Internal(const UObject* WorldContextObject, UFXSystemAsset* SystemTemplate
+		, USceneComponent* AttachToComponent, FName SocketName, const FTransform& Transform);
+
+	// 特效组件的系统是否包含循环发射器。
+	// Whether the system of the FX component contains looping emitters.
+	static bool IsLoopingFX(const UFXSystemComponent* FXComponent);
+
+	// 监听特效组件播放完毕，TargetActor为等待它的特效Actor，为空时组件播放完毕后回收到Component池。
+	// Listen for the FX component to finish, TargetActor is the FX Actor waiting for it, the component returns to the Component pool when it's null.
+	void BindFXFinished(UFXSystemComponent* FXComponent, AActor* TargetActor);
+
+	void UnbindFXFinished(UFXSystemComponent* FXComponent);
+
+	// 停止等待特效Actor的特效播放完毕，Actor被回收时调用。
+	// Stop waiting for the effects of an FX Actor to finish, called when the Actor is released.
+	void StopWaitingForFX(AActor* Actor);
+
+	UFUNCTION()
+	void OnNiagaraSystemFinished(UNiagaraComponent* PSystem);
+
+	UFUNCTION()
+	void OnParticleSystemFinished(UParticleSystemComponent* PSystem);
+
+	void OnFXSystemFinished(UFXSystemComponent* FXComponent);
+
+	// 等待特效播放完毕的特效Actor，以及它们尚未播放完毕的特效数量。
+	// FX Actors waiting for their effects to finish, and the number of their effects not finished yet.
+	TMap<TObjectKey<AActor>, int32> PendingFXActors;
+
+	// 每个被监听的特效组件播放完毕时的处理目标，值为空表示回收到Component池。
+	// Target of every listened FX component when it finishes, a null value means releasing it to the Component pool.
+	TMap<TObjectKey<UFXSystemComponent>, TWeakObjectPtr<AActor>> FXComponentTargets;
+
+#pragma endregion
+
+
+#pragma region ActorPool_ActiveSet
+
+public:
+	// 把所有正在使用的池化Actor回收到Actor池里。bWithinFrameBudget为true时会分摊到多帧中回收，使每帧的回收耗时不超过预算。
+	// Recall all pooled Actors in use back into the Actor pools. If bWithinFrameBudget is true, the releases are spread across frames so each frame stays under the release budget.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ActorPool_RecallAll(bool bWithinFrameBudget = true);
+
+	// 把指定类的Actor池中所有正在使用的Actor回收。
+	// Recall all Actors in use of the actor pool of specified class.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ActorPool_RecallByClass(TSubclassOf<AActor> ActorClass, bool bWithinFrameBudget = true);
+
+	// 把指定ID的Actor池中所有正在使用的Actor回收。
+	// Recall all Actors in use of the actor pool of specified ID.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ActorPool_RecallByID(FName ActorID, bool bWithinFrameBudget = true);
+
+	// 把Owner为指定Actor的所有正在使用的池化Actor回收。
+	// Recall all pooled Actors in use whose Owner is the specified Actor.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ActorPool_RecallByOwner(AActor* Owner, bool bWithinFrameBudget = true);
+
+	// 把Instigator为指定Pawn的所有正在使用的池化Actor回收。
+	// Recall all pooled Actors in use whose Instigator is the specified Pawn.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ActorPool_RecallByInstigator(APawn* Instigator, bool bWithinFrameBudget = true);
+
+	// 返回指定类的Actor池中所有正在使用的Actor。
+	// Return all Actors in use of the actor pool of specified class.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static TArray<AActor*> ActorPool_GetActiveActorsOfClass(TSubclassOf<AActor> ActorClass);
+
+	// 返回指定ID的Actor池中所有正在使用的Actor。
+	// Return all Actors in use of the actor pool of specified ID.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static TArray<AActor*> ActorPool_GetActiveActorsOfID(FName ActorID);
+
+protected:
+	// 记录从对象池中取出的Actor，如果已经记录过则更新其记录。
+	// Record an Actor taken out from the pool, or update its record if it has been recorded.
+	static void TrackActiveActor(FFireflyActorPool& Pool, TSubclassOf<AActor> PoolClass, FName PoolID, AActor* Actor, const AActor* Owner);
+
+	// 以Actor回收时所属的对象池记录从对象池中取出的Actor。
+	// Record an Actor taken out from the pool under the pool it will be released into.
+	static void TrackActiveActor(AActor* Actor, const AActor* Owner);
+
+	static void TrackActiveActor(AActor* Actor, FName ActorID, const AActor* Owner);
+
+	// 移除正在使用的Actor的记录，OutVariant不为空时返回记录中的变体。
+	// Remove the record of an Actor in use, returns the variant in the record through OutVariant if it isn't null.
+	static void UntrackActiveActor(const AActor* Actor, FName* OutVariant = nullptr);
+
+	// 设置正在使用的Actor回收时所属的变体。
+	// Set the variant an Actor in use is released under.
+	static void SetActiveVariant(const AActor* Actor, FName Variant);
+
+	// 查找Actor回收时所属的对象池。
+	// Find the pool the Actor will be released into.
+	static FFireflyActorPool* FindPoolOfActor(const AActor* Actor);
+
+	// Actor是否已经在对象池中待命，重复回收这样的Actor会让它在对象池中出现两次。
+	// Whether the Actor is already on standby in its pool, releasing such an Actor again would put it in the pool twice.
+	static bool IsActorOnStandby(const AActor* Actor);
+
+	static void UntrackActiveActorAt(FFireflyActorPool& Pool, int32 Index);
+
+	// 正在使用的Actor被销毁或离开世界时移除其记录，避免对象池保留失效的记录和句柄。
+	// Remove the record of an Actor in use when it is destroyed or leaves the world, so the pool keeps no stale records or handles.
+	UFUNCTION()
+	void OnActiveActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+	// 把满足条件的正在使用的Actor全部回收。
+	// Recall all Actors in use that match the predicate.
+	static void RecallActors_Internal(TFunctionRef<bool(const AActor*)> Predicate, bool bWithinFrameBudget);
+
+	static void RecallPool_Internal(FFireflyActorPool* Pool, bool bWithinFrameBudget);
+
+	// 把Actor加入待回收队列，由子系统在每帧的回收预算内回收。
+	// Queue an Actor for release, the subsystem releases it within the per-frame release budget.
+	static void QueueRelease(AActor* Actor);
+
+	// 在每帧的回收预算内处理待回收队列。
+	// Process the pending release queue within the per-frame release budget.
+	void ProcessPendingReleases();
+
+	// 所有正在使用的Actor所在的对象池及其位置。
+	// The pool and position of every Actor in use.
+	static TMap<TObjectKey<AActor>, FFireflyActiveActorHandle> ActiveActorHandles;
+
+	// 待回收队列。Actor被直接回收或销毁时会从PendingReleaseSet中移除，队列中不在集合里的条目会被跳过。
+	// Pending release queue. Actors are removed from PendingReleaseSet when released directly or destroyed, entries of the queue not in the set are skipped.
+	static TArray<TObjectKey<AActor>> PendingReleaseActors;
+
+	static TSet<TObjectKey<AActor>> PendingReleaseSet;
+
+	// 最近测得的回收一个排队Actor的平均耗时（秒），用来估算每帧预算内能作为一批回收多少个Actor。
+	// Recently measured average time in seconds to release one queued Actor, used to estimate how many Actors fit into one batch within the budget of a frame.
+	static double PendingReleaseSecondsPerActor;
+
+#pragma endregion
+
+
+#pragma region ActorPool_BatchedProjectile
+
+protected:
+	// 开始或停止由对象池统一推进活跃数组中指定位置的抛射物。
+	// Start or stop advancing the projectile at the index of the active array by the pool.
+	static void SetProjectileBatched(FFireflyActorPool& Pool, int32 Index, bool bBatched);
+
+	// 按配置注册或注销对象池的Tick函数，关闭时把所有抛射物交还给它们自己的Tick。
+	// Register or unregister the tick function of the pool according to its configuration, hand all projectiles back to their own ticks when disabled.
+	static void ApplyBatchedProjectileConfig(FFireflyActorPool& Pool, TSubclassOf<AActor> PoolClass, FName PoolID, UWorld* World);
+
+	// 统一推进对象池中所有被推进的抛射物，并成批写回它们的变换。
+	// Advance all batched projectiles of the pool and write their transforms back in bulk.
+	static void TickBatchedProjectiles(FFireflyActorPool& Pool, float DeltaTime);
+
+#pragma endregion
+
+
+#pragma region ActorPool_ReleaseTrigger
+
+protected:
+	// 成批检测所有对象池的自动回收条件，并回收满足条件的Actor。
+	// Evaluate the auto-release triggers of all pools in batch and release the Actors that meet them.
+	void EvaluateReleaseTriggers();
+
+	// 距离下一次检测自动回收条件的剩余时间。
+	// Remaining time until the next evaluation of the auto-release triggers.
+	float ReleaseTriggerCountdown = 0.f;
+
+#pragma endregion
+
+
+#pragma region ActorPool_Lightweight
+
+public:
+	// 在指定对象池中添加一个轻量实例，以该对象池LightweightMesh的一个网格体实例表示，不生成Actor。返回轻量实例的ID，如果对象池没有配置LightweightMesh则返回-1。
+	// Add a lightweight instance to the specified pool, represented by an instance of the LightweightMesh of the pool without spawning an Actor. Return the ID of the lightweight instance, or -1 if the pool has no LightweightMesh configured.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool", Meta = (WorldContext = "WorldContextObject"))
+	static int32 ActorPool_SpawnLightweight(const UObject* WorldContextObject, TSubclassOf<AActor> ActorClass, FName ActorID
+		, const FTransform& Transform);
+
+	// 移除一个轻量实例。
+	// Remove a lightweight instance.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static void ActorPool_ReleaseLightweight(int32 LightweightID);
+
+	// 把轻量实例提升为一个从对象池生成的Actor，生成在轻量实例的变换处，并移除该轻量实例。
+	// Promote a lightweight instance to an Actor spawned from the pool at the transform of the lightweight instance, and remove the lightweight instance.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static AActor* ActorPool_PromoteLightweight(int32 LightweightID, AActor* Owner = nullptr, APawn* Instigator = nullptr);
+
+	// 如果检测结果命中了一个轻量实例，则把它提升为Actor并返回，否则返回空。
+	// If the hit result hits a lightweight instance, promote it to an Actor and return it, otherwise return null.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static AActor* ActorPool_PromoteLightweightHit(const FHitResult& Hit);
+
+	// 把正在使用的池化Actor回收到对象池，并在它当前的变换处添加一个轻量实例代替它。Actor的玩法状态不会被保留。返回轻量实例的ID，如果对象池没有配置LightweightMesh则不会降级并返回-1。
+	// Release a pooled Actor in use back into the pool and add a lightweight instance at its current transform in its place. The gameplay state of the Actor is not kept. Return the ID of the lightweight instance, or -1 without demoting if the pool has no LightweightMesh configured.
+	UFUNCTION(BlueprintCallable, Category = "FireflyObjectPool")
+	static int32 ActorPool_DemoteActor(AActor* Actor);
+
+protected:
+	// 获取对象池的共享轻量实例组件，如果尚未创建或已随世界销毁，则创建一个新的宿主Actor和组件。
+	// Get the shared lightweight instance component of the pool, create a new host Actor and component if it doesn't exist yet or was destroyed with its world.
+	static UInstancedStaticMeshComponent* GetOrCreateLightweightComponent(UWorld* World, FFireflyActorPool& Pool);
+
+	static void RemoveLightweightAt(FFireflyActorPool& Pool, int32 Index);
+
+	static void ClearLightweights(FFireflyActorPool& Pool);
+
+	// 根据玩家视点的距离成批提升和降级所有对象池的实例。
+	// Promote and demote the instances of all pools in batch according to their distance to the player viewpoints.
+	void EvaluateLightweightRelevance();
+
+	// 所有轻量实例所在的对象池及其位置。
+	// The pool and position of every lightweight instance.
+	static TMap<int32, FFireflyActiveActorHandle> LightweightHandles;
+
+	static int32 NextLightweightID;
+
+#pragma endregion
+
+
 #pragma region ActorPool_Debug
 
 public:
@@ -143,35 +771,162 @@ public:
 	UFUNCTION(BlueprintPure, Category = "FireflyObjectPool")
 	static int32 ActorPool_DebugActorNumberOfID(FName ActorID);
 
+	// 返回在对象池中待命的指定类的Actor估算占用的内存（MB），如果不存在指定类的Actor的对象池，则返回-1。
+	// Return the estimated memory (MB) of Actors of a specified class on standby in the object pool. If the object pool for the specified class of Actors does not exist, return -1.
+	UFUNCTION(BlueprintPure, Category = "FireflyObjectPool")
+	static float ActorPool_DebugMemoryOfClass(TSubclassOf<AActor> ActorClass);
+
+	// 返回在对象池中待命的指定ID的Actor估算占用的内存（MB），如果不存在指定ID的Actor的对象池，则返回-1。
+	// Return the estimated memory (MB) of Actors of a specified ID on standby in the object pool. If the object pool for the specified ID of Actors does not exist, return -1.
+	UFUNCTION(BlueprintPure, Category = "FireflyObjectPool")
+	static float ActorPool_DebugMemoryOfID(FName ActorID);
+
+	// 返回所有对象池中待命的Actor估算占用的内存总量（MB）。
+	// Return the total estimated memory (MB) of Actors on standby in all object pools.
+	UFUNCTION(BlueprintPure, Category = "FireflyObjectPool")
+	static float ActorPool_DebugMemoryTotal();
+
+	// 把所有对象池的数量和估算内存输出到指定的输出设备，会被memreport调用。
+	// Dump the count and estimated memory of all object pools to the specified output device, invoked by memreport.
+	static void ActorPool_DumpMemory(FOutputDevice& Ar);
+
+	// 对比从类默认对象生成和从模板实例生成的单次耗时，用于评估模板生成的收益。
+	// Compare the per-spawn cost of spawning from class defaults and from a template instance, used to evaluate the savings of template spawning.
+	static void ActorPool_BenchmarkSpawn(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar);
+
+	// 对比待命Actor组成GC簇前后的完整垃圾回收耗时，用于评估GC簇的收益。
+	// Compare the full garbage collection time with and without the Actors on standby clustered, used to evaluate the savings of GC clusters.
+	static void ActorPool_BenchmarkGC(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar);
+
+	// 对比整波角色新生成与从对象池重新启用（及回收）的单个角色耗时，以及重置动画实例与重新初始化动画实例的耗时，用于评估角色快速重置的收益。
+	// Compare the per-character cost of spawning a whole wave of characters fresh and of reactivating (and releasing) them from the pool, and of resetting the anim instance against reinitializing it, used to evaluate the savings of the character fast reset.
+	static void ActorPool_BenchmarkCharacterWave(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar);
+
+protected:
+	// 采样单个Actor及其所有组件估算占用的内存字节数。
+	// Sample the estimated memory in bytes of a single Actor and all its components.
+	static int64 SampleActorBytes(const AActor* Actor);
+
+	// 如果对象池尚未采样，则用其中的一个Actor进行采样。
+	// Sample the pool with one of its Actors if it hasn't been sampled yet.
+	static void SamplePool(FFireflyActorPool& Pool, const AActor* Actor = nullptr);
+
+#pragma endregion
+
+
+#pragma region ActorPool_GC
+
+public:
+	// 创建和销毁向垃圾回收报告所有对象池引用的对象，由模块启动和关闭时调用。
+	// Create and destroy the object reporting the references of all pools to garbage collection, called on module startup and shutdown.
+	static void StartupReferenceCollector();
+
+	static void ShutdownReferenceCollector();
+
+protected:
+	// 向垃圾回收报告所有对象池中待命的Actor、模板实例、GC簇根和待命的Component。
+	// Report the Actors on standby, template instances, GC cluster roots and Components on standby of all pools to garbage collection.
+	static void AddPoolReferences(FReferenceCollector& Collector);
+
+	// 对象池的待命Actor发生变化，解散其GC簇并重新开始计时。
+	// The Actors on standby in the pool changed, dissolve its GC cluster and restart the countdown.
+	static void MarkPoolStockChanged(FFireflyActorPool& Pool);
+
+	// 把待命Actor组成GC簇，返回簇中对象的数量。
+	// Group the Actors on standby into a GC cluster, return the number of objects in the cluster.
+	static int32 ClusterPool(FFireflyActorPool& Pool);
+
+	static void DissolvePoolCluster(FFireflyActorPool& Pool);
+
+	// 为待命Actor一段时间没有变化的对象池创建GC簇。
+	// Create GC clusters for pools whose Actors on standby haven't changed for a while.
+	static void UpdatePoolClusters(float DeltaTime);
+
 #pragma endregion
 
 
 #pragma region ActorPool_Declaration
 
 protected:
-	typedef TArray<TObjectPtr<AActor>> TActorPoolList;
+	static TMap<TSubclassOf<AActor>, FFireflyActorPool> ActorPoolOfClass;
 
-	static TMap<TSubclassOf<AActor>, TActorPoolList> ActorPoolOfClass;
+	static TMap<FName, FFireflyActorPool> ActorPoolOfID;
 
-	static TMap<FName, TActorPoolList> ActorPoolOfID;
+	typedef TArray<TObjectPtr<UActorComponent>> TComponentPoolList;
+
+	static TMap<TSubclassOf<UActorComponent>, TComponentPoolList> ComponentPoolOfClass;
 
 #pragma endregion
 };
 
+/**
+ * 在作用域内从对象池取出的Actor，其重叠检测和子组件变换更新会推迟到作用域结束时统一提交。
+ * 延迟的移动作用域只包含传送，PoolingBeginPlay等激活流程会推迟到变换提交之后执行，所以作用域内返回的Actor尚未激活。作用域结束前不要销毁其中取出的Actor。
+ *
+ * Actors taken out from the object pool within this scope have their overlap and child transform updates deferred and committed when the scope ends.
+ * The deferred movement scopes only cover the teleports, activation such as PoolingBeginPlay runs after the transforms are committed, so Actors returned within the scope aren't activated yet. Don't destroy Actors taken out within the scope before it ends.
+ */
+class FIREFLYOBJECTPOOL_API FFireflyScopedActorPoolBatch
+{
+public:
+	FFireflyScopedActorPoolBatch();
+	~FFireflyScopedActorPoolBatch();
+
+	UE_NONCOPYABLE(FFireflyScopedActorPoolBatch);
+
+	// 如果当前处于批处理作用域内，则推迟该组件的移动更新直到作用域结束。
+	// Defer the movement updates of the component until the scope ends if a batch scope is active.
+	static void DeferMovementUpdates(USceneComponent* Component);
+
+	// 如果当前处于批处理作用域内，则把激活流程推迟到作用域提交变换之后执行，返回是否已推迟。
+	// Defer the activation until the scope has committed the transforms if a batch scope is active, returns whether it was deferred.
+	static bool DeferActivation(TFunction<void()>&& Activation);
+
+private:
+	TArray<TUniquePtr<FScopedMovementUpdate>> MovementScopes;
+
+	TArray<TFunction<void()>> PendingActivations;
+
+	FFireflyScopedActorPoolBatch* OuterBatch = nullptr;
+
+	static FFireflyScopedActorPoolBatch* CurrentBatch;
+};
+
 #pragma region ActorPool_FunctionTemplate
 
 template <typename T>
 T* UFireflyObjectPoolWorldSubsystem::ActorPool_FetchActor(TSubclassOf<T> ActorClass, FName ActorID)
 {
-	TActorPoolList* Pool = ActorPoolOfID.Find(ActorID);
+	if constexpr (TFireflyPoolingTraits<T>::bNativePooling)
+	{
+		ActorPool_RegisterNativeTraits<T>();
+	}
+
+	FFireflyActorPool* Pool = ActorPoolOfID.Find(ActorID);
+	const bool bPoolOfID = Pool != nullptr;
 	if (!Pool)
 	{
 		Pool = ActorPoolOfClass.Find(ActorClass);
 	}
 
-	if (Pool && Pool->Num() > 0)
+	if (Pool && Pool->Actors.Num() > 0)
 	{
-		T* Actor = Pool->Pop(false);
+		// 先检查类型再取出，类型不符的Actor留在池中，不会因转换失败而丢失。
+		// Check the type before taking the Actor out, an Actor of another type stays in the pool instead of being lost to a failed cast.
+		const AActor* NextActor = Pool->Actors.Last();
+		if (IsValid(NextActor) && !NextActor->IsA<T>())
+		{
+			return nullptr;
+		}
+
+		MarkPoolStockChanged(*Pool);
+		FName Variant = NAME_None;
+		T* Actor = Cast<T>(Pool->PopActor(&Variant));
+		if (Actor)
+		{
+			TrackActiveActor(*Pool, bPoolOfID ? nullptr : ActorClass.Get(), bPoolOfID ? ActorID : NAME_None, Actor, Actor->GetOwner());
+			SetActiveVariant(Actor, Variant);
+		}
 
 		return Actor;
 	}
@@ -198,9 +953,121 @@ TArray<T*> UFireflyObjectPoolWorldSubsystem::ActorPool_FetchActors(TSubclassOf<T
 template<typename T>
 T* UFireflyObjectPoolWorldSubsystem::ActorPool_SpawnActor(TSubclassOf<T> ActorClass, FName ActorID
 	, const FTransform& Transform, float Lifetime, AActor* Owner, APawn* Instigator
-	, const ESpawnActorCollisionHandlingMethod CollisionHandling)
+	, const ESpawnActorCollisionHandlingMethod CollisionHandling, bool bSweep)
+{
+	using FTraits = TFireflyPoolingTraits<T>;
+	if constexpr (!FTraits::bNativePooling)
+	{
+		return Cast<T>(SpawnActor_Internal(ActorClass, ActorID, Transform, Lifetime, Owner, Instigator, CollisionHandling, bSweep));
+	}
+	else
+	{
+		if (!IsValid(ActorClass) && ActorID == NAME_None)
+		{
+			return nullptr;
+		}
+
+		T* Actor = ActorPool_FetchActor<T>(ActorClass, ActorID);
+		if (!Actor)
+		{
+			// 借用只会取出与ActorClass完全相同类的Actor。
+			// Borrowing only takes out Actors of exactly ActorClass.
+			Actor = static_cast<T*>(BorrowActor_Internal(ActorClass, ActorID));
+		}
+
+		const bool bFetched = Actor != nullptr;
+		if (Actor)
+		{
+			TeleportFetchedActor(Actor, Transform, bSweep);
+			Actor->SetOwner(Owner);
+		}
+		else
+		{
+			if (!IsValid(ActorClass))
+			{
+				return nullptr;
+			}
+
+			Actor = static_cast<T*>(SpawnNewActor_Internal(GetWorld(), ActorClass, ActorID, Transform, Owner, Instigator, CollisionHandling));
+			if (!IsValid(Actor))
+			{
+				return nullptr;
+			}
+		}
+
+		if (ActorID != NAME_None && FTraits::PoolingGetActorID(Actor) != ActorID)
+		{
+			FTraits::PoolingSetActorID(Actor, ActorID);
+		}
+
+		auto Activate = [Lifetime](AActor* InActor, AActor* InOwner)
+		{
+			T* TypedActor = static_cast<T*>(InActor);
+			FTraits::PoolingBeginPlay(TypedActor);
+
+			TrackActiveActor(TypedActor, FTraits::PoolingGetActorID(TypedActor), InOwner);
+			SetActorLifetime_Internal(TypedActor, Lifetime);
+		};
+		if (!bFetched || !DeferFetchedActivation(Actor, Owner, Activate))
+		{
+			Activate(Actor, Owner);
+		}
+
+		return Actor;
+	}
+}
+
+template <typename T>
+void UFireflyObjectPoolWorldSubsystem::ActorPool_ReleaseActor(T* Actor)
+{
+	using FTraits = TFireflyPoolingTraits<T>;
+	if constexpr (!FTraits::bNativePooling)
+	{
+		ActorPool_ReleaseActor(static_cast<AActor*>(Actor));
+	}
+	else
+	{
+		if (!IsValid(Actor) || IsActorOnStandby(Actor))
+		{
+			return;
+		}
+
+		ActorPool_RegisterNativeTraits<T>();
+		const FName Variant = DetachReleasedActor_Internal(Actor);
+
+		const FName ActorID = FTraits::PoolingGetActorID(Actor);
+		FTraits::PoolingEndPlay(Actor);
+
+		ReturnActorToPool_Internal(Actor, ActorID, Variant);
+	}
+}
+
+template <typename T>
+void UFireflyObjectPoolWorldSubsystem::ActorPool_RegisterNativeTraits()
+{
+	static bool bRegistered = false;
+	if (!bRegistered)
+	{
+		NativeHooksOfClass.Add(T::StaticClass(), &FFireflyPoolingNativeHooks::Get<T>());
+		ResolvedNativeHooksOfClass.Empty();
+		bRegistered = true;
+	}
+}
+
+template <typename T>
+T* UFireflyObjectPoolWorldSubsystem::WidgetPool_FetchWidget(const UObject* WorldContextObject, TSubclassOf<T> WidgetClass
+	, APlayerController* OwningPlayer)
+{
+	return Cast<T>(K2_WidgetPool_FetchWidget(WorldContextObject, TSubclassOf<UUserWidget>(WidgetClass), OwningPlayer));
+}
+
+template <typename T>
+T* UFireflyObjectPoolWorldSubsystem::ComponentPool_SpawnComponent(const UObject* WorldContextObject
+	, TSubclassOf<T> ComponentClass, AActor* Host, USceneComponent* AttachParent, FName SocketName
+	, const FTransform& RelativeTransform)
 {
-	return Cast<T>(SpawnActor_Internal(ActorClass, ActorID, Transform, Lifetime, Owner, Instigator, CollisionHandling));
+	return Cast<T>(K2_ComponentPool_SpawnComponent(WorldContextObject, TSubclassOf<UActorComponent>(ComponentClass)
+		, Host, AttachParent, SocketName, RelativeTransform));
 }
 
 #pragma endregion
\ No newline at end of file
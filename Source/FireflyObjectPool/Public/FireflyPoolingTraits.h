@@ -0,0 +1,85 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+
+
+/**
+ * 原生Actor类的编译期池化特性。默认不启用，池化流程走IFireflyPoolingActorInterface的反射调用。
+ * 为某个C++ Actor类特化该模板并继承TFireflyNativePoolingTraits后，带类型的模板函数（如ActorPool_SpawnActor<T>、ActorPool_ReleaseActor<T>）会直接内联调用特性中的函数。
+ *
+ * Compile-time pooling traits of native Actor classes. Disabled by default, the pooling flow goes through the reflective calls of IFireflyPoolingActorInterface.
+ * Once the template is specialized for a C++ Actor class deriving from TFireflyNativePoolingTraits, the typed templates (such as ActorPool_SpawnActor<T> and ActorPool_ReleaseActor<T>) inline the functions of the traits directly.
+ *
+ *	template<>
+ *	struct TFireflyPoolingTraits<AMyBullet> : TFireflyNativePoolingTraits<AMyBullet>
+ *	{
+ *		static void PoolingBeginPlay(AMyBullet* Bullet) { Bullet->Activate(); }
+ *		static void PoolingEndPlay(AMyBullet* Bullet) { Bullet->Deactivate(); }
+ *	};
+ */
+template<typename T>
+struct TFireflyPoolingTraits
+{
+	static constexpr bool bNativePooling = false;
+};
+
+/** 原生池化特性的默认实现，特化TFireflyPoolingTraits时继承它并只覆盖需要的函数 */
+/** Default implementation of native pooling traits, derive from it when specializing TFireflyPoolingTraits and override only the needed functions */
+template<typename T>
+struct TFireflyNativePoolingTraits
+{
+	static constexpr bool bNativePooling = true;
+
+	// Actor从对象池中生成后执行。
+	// Executed after the Actor is spawned from the object pool.
+	static void PoolingBeginPlay(T* Actor) {}
+
+	// Actor被放回对象池中后执行。
+	// Executed after the Actor is returned to the object pool.
+	static void PoolingEndPlay(T* Actor) {}
+
+	// Actor被预先生成并放进对象池待命后执行。
+	// Executed after the Actor is spawned in advance and put on standby in the object pool.
+	static void PoolingWarmUp(T* Actor) {}
+
+	// 获取Actor的ID，返回NAME_None时Actor属于类的对象池。
+	// Get the ID of the Actor, the Actor belongs to the class-based pool when NAME_None is returned.
+	static FName PoolingGetActorID(const T* Actor) { return NAME_None; }
+
+	// 设置Actor的ID。
+	// Set the ID of the Actor.
+	static void PoolingSetActorID(T* Actor, FName ActorID) {}
+};
+
+/** 原生池化特性的类型擦除入口，供不带类型的通用流程（蓝图、回收触发器、召回等）调用已注册类的特性 */
+/** Type-erased entry of native pooling traits, lets the untyped generic paths (Blueprint, release triggers, recall, etc.) call the traits of registered classes */
+struct FFireflyPoolingNativeHooks
+{
+	void (*BeginPlay)(AActor*) = nullptr;
+	void (*EndPlay)(AActor*) = nullptr;
+	void (*WarmUp)(AActor*) = nullptr;
+	FName (*GetActorID)(const AActor*) = nullptr;
+	void (*SetActorID)(AActor*, FName) = nullptr;
+
+	template<typename T>
+	static const FFireflyPoolingNativeHooks& Get()
+	{
+		using FTraits = TFireflyPoolingTraits<T>;
+		static_assert(FTraits::bNativePooling, "TFireflyPoolingTraits is not specialized for this class.");
+
+		static const FFireflyPoolingNativeHooks Hooks =
+		{
+			[](AActor* Actor) { FTraits::PoolingBeginPlay(static_cast<T*>(Actor)); },
+			[](AActor* Actor) { FTraits::PoolingEndPlay(static_cast<T*>(Actor)); },
+			[](AActor* Actor) { FTraits::PoolingWarmUp(static_cast<T*>(Actor)); },
+			[](const AActor* Actor) { return FTraits::PoolingGetActorID(static_cast<const T*>(Actor)); },
+			[](AActor* Actor, FName ActorID) { FTraits::PoolingSetActorID(static_cast<T*>(Actor), ActorID); }
+		};
+
+		return Hooks;
+	}
+};
@@ -0,0 +1,40 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "FireflyPoolingWidgetInterface.generated.h"
+
+
+UINTERFACE(MinimalAPI, BlueprintType)
+class UFireflyPoolingWidgetInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/** Widget池生成的Widget需要实现的接口 */
+/** Interface that widgets spawned from widget pool should implement */
+class FIREFLYOBJECTPOOL_API IFireflyPoolingWidgetInterface
+{
+	GENERATED_BODY()
+
+public:
+	// Widget从对象池中取出后执行的激活。
+	// Activation executed after the Widget is taken out from the object pool.
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "FireflyObjectPool")
+	void PoolingActivate();
+	virtual void PoolingActivate_Implementation() {}
+
+	// Widget被放回对象池中后执行的停用。
+	// Deactivation executed after the Widget is returned to the object pool.
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "FireflyObjectPool")
+	void PoolingDeactivate();
+	virtual void PoolingDeactivate_Implementation() {}
+
+	// Widget从对象池中生成后等待使用执行的WarmUp。
+	// WarmUp executed after the Widget is created by the object pool, waiting to be used.
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "FireflyObjectPool")
+	void PoolingWarmUp();
+	virtual void PoolingWarmUp_Implementation() {}
+};
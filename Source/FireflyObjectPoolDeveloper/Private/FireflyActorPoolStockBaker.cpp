@@ -0,0 +1,128 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#include "FireflyActorPoolStockBaker.h"
+
+#include "Editor.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+
+#include "FireflyActorPoolStock.h"
+#include "FireflyObjectPoolLibrary.h"
+#include "FireflyPoolingActorInterface.h"
+
+
+DEFINE_LOG_CATEGORY_STATIC(LogFireflyActorPoolStock, Log, All);
+
+FDelegateHandle FFireflyActorPoolStockBaker::PreSaveHandle;
+
+void FFireflyActorPoolStockBaker::Register()
+{
+	PreSaveHandle = FEditorDelegates::PreSaveWorldWithContext.AddStatic(&FFireflyActorPoolStockBaker::OnPreSaveWorld);
+}
+
+void FFireflyActorPoolStockBaker::Unregister()
+{
+	FEditorDelegates::PreSaveWorldWithContext.Remove(PreSaveHandle);
+	PreSaveHandle.Reset();
+}
+
+void FFireflyActorPoolStockBaker::BakeStock(AFireflyActorPoolStock* Stock)
+{
+	UWorld* World = Stock->GetWorld();
+	if (!IsValid(World))
+	{
+		return;
+	}
+
+	Stock->Modify();
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.OverrideLevel = Stock->GetLevel();
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (FFireflyActorPoolStockEntry& Entry : Stock->Entries)
+	{
+		for (AActor* Actor : Entry.BakedActors)
+		{
+			if (IsValid(Actor))
+			{
+				World->EditorDestroyActor(Actor, true);
+			}
+		}
+		Entry.BakedActors.Empty();
+
+		if (!IsValid(Entry.ActorClass))
+		{
+			continue;
+		}
+
+		for (int32 i = 0; i < Entry.Count; ++i)
+		{
+			AActor* Actor = World->SpawnActor<AActor>(Entry.ActorClass, Stock->GetActorTransform(), SpawnParameters);
+			if (!IsValid(Actor))
+			{
+				continue;
+			}
+
+			Actor->SetFolderPath(TEXT("FireflyObjectPool"));
+			if (Entry.ActorID != NAME_None && Actor->Implements<UFireflyPoolingActorInterface>())
+			{
+				IFireflyPoolingActorInterface::Execute_PoolingSetActorID(Actor, Entry.ActorID);
+			}
+
+			// 保存待命状态下的可序列化属性（隐藏、关闭碰撞等），加载后无需再次进入待命状态。
+			// Save the serializable properties of the dormant state (hidden, collision disabled, etc.), so they don't need to enter it again after loading.
+			UFireflyObjectPoolLibrary::UniversalWarmUp_Actor(Stock, Actor);
+
+			// Tick和组件激活是运行时状态，不会被保存，这里把它们写进会被保存的初始设置，使Actor加载后不会开始Tick或自动激活组件。
+			// Ticking and component activation are runtime state that isn't saved, write them into the saved start settings here so the Actor neither starts ticking nor auto-activates its components on load.
+			Actor->PrimaryActorTick.bStartWithTickEnabled = false;
+			TInlineComponentArray<UActorComponent*> Components;
+			Actor->GetComponents(Components);
+			for (UActorComponent* Component : Components)
+			{
+				Component->PrimaryComponentTick.bStartWithTickEnabled = false;
+				Component->bAutoActivate = false;
+			}
+
+			Entry.BakedActors.Add(Actor);
+		}
+	}
+}
+
+void FFireflyActorPoolStockBaker::OnPreSaveWorld(UWorld* World, FObjectPreSaveContext SaveContext)
+{
+	if (!World || !World->PersistentLevel)
+	{
+		return;
+	}
+
+	// 烘焙时只检查预先放置的Actor，不在烘焙过程中生成Actor，过期的配置需要在编辑器中保存关卡来更新。
+	// Cooking only verifies the pre-placed Actors and never spawns any, an outdated stock has to be updated by saving the level in the editor.
+	const bool bVerifyOnly = SaveContext.IsCooking() || SaveContext.IsProceduralSave();
+
+	bool bBaked = false;
+	for (AActor* Actor : World->PersistentLevel->Actors)
+	{
+		AFireflyActorPoolStock* Stock = Cast<AFireflyActorPoolStock>(Actor);
+		if (!IsValid(Stock) || Stock->IsStockUpToDate())
+		{
+			continue;
+		}
+
+		if (bVerifyOnly)
+		{
+			UE_LOG(LogFireflyActorPoolStock, Warning, TEXT("%s in %s is out of date, save the level in the editor to bake it again.")
+				, *Stock->GetName(), *World->GetOutermost()->GetName());
+			continue;
+		}
+
+		BakeStock(Stock);
+		bBaked = true;
+	}
+
+	if (bBaked)
+	{
+		World->PersistentLevel->MarkPackageDirty();
+	}
+}
@@ -0,0 +1,27 @@
+// Copyright tzlFirefly, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectSaveContext.h"
+
+class AFireflyActorPoolStock;
+
+/** 在编辑器中保存关卡时，把关卡中AFireflyActorPoolStock配置的对象池待命Actor预先放置进关卡，烘焙时只检查预先放置的Actor是否与配置一致 */
+/** Pre-places the pools' Actors on standby configured by the AFireflyActorPoolStock in a level when the level is saved in the editor, cooking only verifies that the pre-placed Actors match the configuration */
+class FFireflyActorPoolStockBaker
+{
+public:
+	static void Register();
+
+	static void Unregister();
+
+	// 销毁之前预先放置的Actor，并按配置重新生成待命Actor放置进关卡。
+	// Destroy the previously pre-placed Actors and spawn the configured Actors on standby into the level again.
+	static void BakeStock(AFireflyActorPoolStock* Stock);
+
+private:
+	static void OnPreSaveWorld(UWorld* World, FObjectPreSaveContext SaveContext);
+
+	static FDelegateHandle PreSaveHandle;
+};
@@ -2,17 +2,21 @@
 
 #include "FireflyObjectPoolDeveloperModule.h"
 
+#include "FireflyActorPoolStockBaker.h"
+
 #define LOCTEXT_NAMESPACE "FFireflyObjectPoolDeveloperModule"
 
 void FFireflyObjectPoolDeveloperModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	FFireflyActorPoolStockBaker::Register();
 }
 
 void FFireflyObjectPoolDeveloperModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FFireflyActorPoolStockBaker::Unregister();
 }
 
 #undef LOCTEXT_NAMESPACE